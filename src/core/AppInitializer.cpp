@@ -0,0 +1,236 @@
+#include "AppInitializer.h"
+#include "ThreadPlacement.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <algorithm>
+
+namespace {
+
+QElapsedTimer& processClock()
+{
+    static QElapsedTimer clock;
+    return clock;
+}
+
+} // namespace
+
+AppInitializer::AppInitializer(QObject* parent)
+    : QObject(parent)
+{
+}
+
+AppInitializer::~AppInitializer()
+{
+    waitForFinished();
+}
+
+void AppInitializer::addTask(Component component, std::function<bool()> task)
+{
+    m_tasks.push_back({component, std::move(task)});
+}
+
+void AppInitializer::start()
+{
+    m_timer.start();
+    for (auto& task : m_tasks) {
+        Component component = task.component;
+        std::function<bool()> run = std::move(task.run);
+
+        m_threads.emplace_back([this, component, run]() {
+            ThreadPlacement::apply(ThreadRole::Background);
+            bool success = false;
+            try {
+                success = run();
+            } catch (const std::exception& e) {
+                qDebug() << "Init task" << componentName(component) << "threw:" << e.what();
+            }
+
+            // 回到主线程更新状态；初始化器已销毁时该调用被丢弃
+            QMetaObject::invokeMethod(this, [this, component, success]() {
+                setState(component, success ? State::Ready : State::Failed);
+            }, Qt::QueuedConnection);
+        });
+    }
+    m_tasks.clear();
+}
+
+void AppInitializer::runInBackground(std::function<bool()> task, std::function<void(bool)> done)
+{
+    const quint64 id = m_nextBackgroundId++;
+    m_backgroundThreads.emplace(id, std::thread([this, id, task, done]() {
+        // 本线程由已放置的界面线程创建，先恢复为后台角色的策略
+        ThreadPlacement::apply(ThreadRole::Background);
+        bool success = false;
+        try {
+            success = task();
+        } catch (const std::exception& e) {
+            qDebug() << "Background task threw:" << e.what();
+        }
+
+        // 回到主线程：先回收本线程（此时它只剩退出），再通知调用方
+        QMetaObject::invokeMethod(this, [this, id, done, success]() {
+            auto it = m_backgroundThreads.find(id);
+            if (it != m_backgroundThreads.end()) {
+                it->second.join();
+                m_backgroundThreads.erase(it);
+            }
+            if (done) {
+                done(success);
+            }
+        }, Qt::QueuedConnection);
+    }));
+}
+
+void AppInitializer::waitForFinished()
+{
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+    for (auto& entry : m_backgroundThreads) {
+        if (entry.second.joinable()) {
+            entry.second.join();
+        }
+    }
+    m_backgroundThreads.clear();
+}
+
+AppInitializer::State AppInitializer::state(Component component) const
+{
+    switch (component) {
+    case Model:    return m_model;
+    case Database: return m_database;
+    case Camera:   return m_camera;
+    }
+    return State::Pending;
+}
+
+AppInitializer::State& AppInitializer::stateRef(Component component)
+{
+    switch (component) {
+    case Database: return m_database;
+    case Camera:   return m_camera;
+    default:       return m_model;
+    }
+}
+
+bool AppInitializer::isReady(Components components) const
+{
+    for (Component c : {Model, Database, Camera}) {
+        if (components.testFlag(c) && state(c) != State::Ready) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AppInitializer::setState(Component component, State state)
+{
+    stateRef(component) = state;
+
+    const qint64 elapsed = m_timer.isValid() ? m_timer.elapsed() : 0;
+    if (state != State::Pending) {
+        milestone(componentName(component) + (state == State::Ready ? " ready" : " failed"));
+    }
+    emit componentStateChanged(component, state, elapsed);
+    dispatchPending();
+}
+
+bool AppInitializer::isSettled(Components dependencies, Component* failed) const
+{
+    // 等所有依赖都有结果后再判定，避免其他依赖尚在加载时就按失败处理
+    for (Component c : {Model, Database, Camera}) {
+        if (!dependencies.testFlag(c)) {
+            continue;
+        }
+        if (state(c) == State::Pending) {
+            return false;
+        }
+        if (state(c) == State::Failed && *failed == Component(0)) {
+            *failed = c;
+        }
+    }
+    return true;
+}
+
+void AppInitializer::whenReady(Components dependencies, const QString& name,
+                               std::function<void()> action, FailureHandler onFailed)
+{
+    // 同名操作只保留最后一次（如重复点击启动按钮）
+    cancel(name);
+    m_pending.push_back({dependencies, name, std::move(action), std::move(onFailed)});
+    dispatchPending();
+}
+
+void AppInitializer::cancel(const QString& name)
+{
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                   [&name](const PendingAction& p) { return p.name == name; }),
+                    m_pending.end());
+}
+
+void AppInitializer::dispatchPending()
+{
+    // 先取出可执行的操作再调用，回调中可能继续提交新操作
+    std::vector<std::pair<PendingAction, Component>> ready;
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        Component failed = Component(0);
+        if (isSettled(it->dependencies, &failed)) {
+            ready.emplace_back(std::move(*it), failed);
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto& [pending, failed] : ready) {
+        if (failed == Component(0)) {
+            if (pending.action) {
+                pending.action();
+            }
+        } else if (pending.onFailed) {
+            pending.onFailed(failed);
+        } else {
+            qDebug() << "Dropped" << pending.name << "because" << componentName(failed) << "failed";
+        }
+    }
+}
+
+void AppInitializer::markProcessStart()
+{
+    processClock().start();
+}
+
+qint64 AppInitializer::sinceProcessStart()
+{
+    return processClock().isValid() ? processClock().elapsed() : 0;
+}
+
+void AppInitializer::milestone(const QString& name)
+{
+    const qint64 t = sinceProcessStart();
+    m_milestones.emplace_back(name, t);
+    qDebug() << "Startup milestone:" << name << "at" << t << "ms";
+}
+
+void AppInitializer::reportMilestones() const
+{
+    qDebug() << "===== Startup timeline (ms since process start) =====";
+    qint64 last = 0;
+    for (const auto& [name, t] : m_milestones) {
+        qDebug().noquote() << QString("%1 %2 (+%3)").arg(name, -24).arg(t, 6).arg(t - last);
+        last = t;
+    }
+}
+
+QString AppInitializer::componentName(Component component)
+{
+    switch (component) {
+    case Model:    return "model";
+    case Database: return "database";
+    case Camera:   return "camera";
+    }
+    return "unknown";
+}
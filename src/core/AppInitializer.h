@@ -0,0 +1,103 @@
+#ifndef APPINITIALIZER_H
+#define APPINITIALIZER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <functional>
+#include <map>
+#include <thread>
+#include <vector>
+
+// 分阶段异步初始化：模型加载、数据库迁移、摄像头探测在各自的后台线程并发执行，
+// 完成后回到主线程更新组件状态；依赖未就绪的操作排队，就绪后按顺序执行
+class AppInitializer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Component {
+        Model    = 0x1,
+        Database = 0x2,
+        Camera   = 0x4
+    };
+    Q_DECLARE_FLAGS(Components, Component)
+
+    enum class State {
+        Pending,
+        Ready,
+        Failed
+    };
+
+    // 依赖中有组件失败时调用，参数为第一个失败的组件
+    using FailureHandler = std::function<void(Component failed)>;
+
+    explicit AppInitializer(QObject* parent = nullptr);
+    ~AppInitializer();
+
+    // task 在后台线程执行，返回是否成功；须在 start() 之前添加
+    void addTask(Component component, std::function<bool()> task);
+    void start();
+    // 启动后的后台任务（如模型热替换）：task 在后台线程执行，done 回到主线程调用
+    void runInBackground(std::function<bool()> task, std::function<void(bool)> done);
+    // 等待所有后台任务结束（析构前调用，保证任务引用的对象仍然有效）
+    void waitForFinished();
+
+    State state(Component component) const;
+    bool isReady(Components components) const;
+    // 组件在启动后被重新初始化（如设置中重新加载模型）时手动更新状态
+    void setState(Component component, State state);
+
+    // 依赖全部就绪时立即执行，否则排队；同名操作重复提交时只保留最后一次
+    void whenReady(Components dependencies, const QString& name,
+                   std::function<void()> action, FailureHandler onFailed = nullptr);
+    // 取消尚未执行的排队操作（如启动前又点了停止）
+    void cancel(const QString& name);
+
+    // 启动里程碑：时间从进程启动（markProcessStart）算起
+    static void markProcessStart();
+    static qint64 sinceProcessStart();
+    void milestone(const QString& name);
+    void reportMilestones() const;
+
+    static QString componentName(Component component);
+
+signals:
+    void componentStateChanged(AppInitializer::Component component,
+                               AppInitializer::State state, qint64 elapsedMs);
+
+private:
+    struct Task {
+        Component component;
+        std::function<bool()> run;
+    };
+
+    struct PendingAction {
+        Components dependencies;
+        QString name;
+        std::function<void()> action;
+        FailureHandler onFailed;
+    };
+
+    std::vector<Task> m_tasks;
+    std::vector<std::thread> m_threads;
+    // 启动后的后台任务线程，完成回调时在主线程回收，不会随热替换次数堆积
+    std::map<quint64, std::thread> m_backgroundThreads;
+    quint64 m_nextBackgroundId = 0;
+    std::vector<PendingAction> m_pending;
+    std::vector<std::pair<QString, qint64>> m_milestones;
+
+    State m_model = State::Pending;
+    State m_database = State::Pending;
+    State m_camera = State::Pending;
+    QElapsedTimer m_timer;
+
+    State& stateRef(Component component);
+    // 依赖全部完成初始化时返回 true，有失败时 failed 为第一个失败的组件
+    bool isSettled(Components dependencies, Component* failed) const;
+    void dispatchPending();
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(AppInitializer::Components)
+
+#endif // APPINITIALIZER_H
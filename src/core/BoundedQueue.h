@@ -0,0 +1,193 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// 队列满时的入队策略
+enum class QueuePolicy {
+    DropOldest,     // 丢弃最旧的一项，保证下游拿到的总是最新数据（实时流）
+    Block           // 等待下游腾出空间，不丢帧（视频文件）
+};
+
+// 有界环形队列（Vyukov 序号槽算法）：入队/出队无锁，容量向上取 2 的幂。
+// 丢弃最旧项时生产者也要出队，所以按多生产者多消费者实现；流水线中每个队列只有一对生产者/消费者。
+// 只有队列空/满需要等待时才使用互斥量和条件变量，且只在有等待者时才通知。
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity, QueuePolicy policy = QueuePolicy::DropOldest)
+        : m_policy(policy)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // 按策略入队；队列已关闭时返回 false
+    bool push(T value)
+    {
+        while (!m_closed.load(std::memory_order_acquire)) {
+            if (tryPush(value)) {
+                m_pushed.fetch_add(1, std::memory_order_relaxed);
+                wakeWaiters();
+                return true;
+            }
+
+            if (m_policy == QueuePolicy::DropOldest) {
+                T discarded;
+                if (tryPop(discarded)) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+
+            waitUntil([this]() { return size() <= m_mask; });
+        }
+        return false;
+    }
+
+    // 阻塞直到取到一项；队列关闭且已取空时返回 false
+    bool pop(T& value)
+    {
+        for (;;) {
+            if (tryPop(value)) {
+                wakeWaiters();
+                return true;
+            }
+            if (m_closed.load(std::memory_order_acquire)) {
+                // 关闭前已入队的数据仍可取出
+                return tryPop(value);
+            }
+            waitUntil([this]() { return size() > 0; });
+        }
+    }
+
+    bool tryPush(T& value)
+    {
+        Cell* cell;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // 满
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        Cell* cell;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // 空
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 关闭后 push 立即失败，pop 取完剩余数据后返回 false
+    void close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_waitCondition.notify_all();
+    }
+
+    bool isClosed() const { return m_closed.load(std::memory_order_acquire); }
+
+    // 近似深度，用于统计和等待判断
+    size_t size() const
+    {
+        const size_t enqueue = m_enqueuePos.load(std::memory_order_acquire);
+        const size_t dequeue = m_dequeuePos.load(std::memory_order_acquire);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+    QueuePolicy policy() const { return m_policy; }
+    uint64_t pushed() const { return m_pushed.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    template <typename Predicate>
+    void waitUntil(Predicate ready)
+    {
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        // 与 wakeWaiters 中的栅栏配对：要么这里看到对方的修改，要么对方看到等待者并通知
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_waitCondition.wait(lock, [this, &ready]() {
+            return ready() || m_closed.load(std::memory_order_acquire);
+        });
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wakeWaiters()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_waitCondition.notify_all();
+        }
+    }
+
+    const QueuePolicy m_policy;
+    size_t m_mask = 0;
+    std::unique_ptr<Cell[]> m_cells;
+
+    // 入队/出队位置分处不同缓存行，避免生产者与消费者伪共享
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+
+    alignas(64) std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_closed{false};
+    std::atomic<int> m_waiters{0};
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,212 @@
+#include "CaptureFormat.h"
+#include <QDebug>
+#include <QtGlobal>
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint32_t fourccCode(char a, char b, char c, char d)
+{
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8)
+           | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+constexpr uint32_t kYUYV = fourccCode('Y', 'U', 'Y', 'V');
+constexpr uint32_t kUYVY = fourccCode('U', 'Y', 'V', 'Y');
+constexpr uint32_t kNV12 = fourccCode('N', 'V', '1', '2');
+constexpr uint32_t kMJPG = fourccCode('M', 'J', 'P', 'G');
+constexpr uint32_t kBGR3 = fourccCode('B', 'G', 'R', '3');
+constexpr uint32_t kRGB3 = fourccCode('R', 'G', 'B', '3');
+
+#if defined(Q_OS_LINUX)
+int xioctl(int fd, unsigned long request, void* arg)
+{
+    int result;
+    do {
+        result = ioctl(fd, request, arg);
+    } while (result == -1 && errno == EINTR);
+    return result;
+}
+
+// 该格式与尺寸下的最高帧率（最短帧间隔）
+double maxFps(int fd, uint32_t fourcc, int width, int height)
+{
+    v4l2_frmivalenum interval{};
+    interval.pixel_format = fourcc;
+    interval.width = static_cast<uint32_t>(width);
+    interval.height = static_cast<uint32_t>(height);
+
+    double best = 0.0;
+    for (interval.index = 0; xioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &interval) == 0; ++interval.index) {
+        const v4l2_fract& fraction = interval.type == V4L2_FRMIVAL_TYPE_DISCRETE
+                                         ? interval.discrete : interval.stepwise.min;
+        if (fraction.numerator > 0) {
+            best = std::max(best, static_cast<double>(fraction.denominator) / fraction.numerator);
+        }
+        if (interval.type != V4L2_FRMIVAL_TYPE_DISCRETE) {
+            break;
+        }
+    }
+    return best;
+}
+#endif
+
+} // namespace
+
+std::vector<CaptureMode> CaptureFormat::probe(int deviceId)
+{
+    std::vector<CaptureMode> modes;
+#if defined(Q_OS_LINUX)
+    const std::string path = "/dev/video" + std::to_string(deviceId);
+    const int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd < 0) {
+        return modes;
+    }
+
+    v4l2_fmtdesc format{};
+    format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    for (format.index = 0; xioctl(fd, VIDIOC_ENUM_FMT, &format) == 0; ++format.index) {
+        v4l2_frmsizeenum size{};
+        size.pixel_format = format.pixelformat;
+        for (size.index = 0; xioctl(fd, VIDIOC_ENUM_FRAMESIZES, &size) == 0; ++size.index) {
+            if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE) {
+                const int width = static_cast<int>(size.discrete.width);
+                const int height = static_cast<int>(size.discrete.height);
+                modes.push_back({format.pixelformat, width, height,
+                                 maxFps(fd, format.pixelformat, width, height)});
+                continue;
+            }
+
+            // 连续/步进范围：取常见分辨率中落在范围内的几档以及上下限
+            const v4l2_frmsize_stepwise& range = size.stepwise;
+            const int candidates[][2] = {
+                {static_cast<int>(range.min_width), static_cast<int>(range.min_height)},
+                {320, 240}, {640, 480}, {1280, 720}, {1920, 1080},
+                {static_cast<int>(range.max_width), static_cast<int>(range.max_height)}};
+            for (const auto& candidate : candidates) {
+                const int width = candidate[0];
+                const int height = candidate[1];
+                if (width < static_cast<int>(range.min_width) || width > static_cast<int>(range.max_width)
+                    || height < static_cast<int>(range.min_height)
+                    || height > static_cast<int>(range.max_height)) {
+                    continue;
+                }
+                modes.push_back({format.pixelformat, width, height,
+                                 maxFps(fd, format.pixelformat, width, height)});
+            }
+            break;
+        }
+    }
+    ::close(fd);
+#else
+    Q_UNUSED(deviceId);
+#endif
+    return modes;
+}
+
+double CaptureFormat::cost(const CaptureMode& mode)
+{
+    double factor;
+    switch (mode.fourcc) {
+    case kYUYV: factor = 1.0; break;    // 原始帧直接进预处理，无单独的颜色转换
+    case kBGR3:
+    case kRGB3: factor = 1.2; break;    // 后端拷贝/换序
+    case kUYVY:
+    case kNV12: factor = 1.5; break;    // 后端做一次 YUV→BGR
+    case kMJPG: factor = 4.0; break;    // JPEG 解码
+    default:    return -1.0;
+    }
+    return factor * mode.width * mode.height;
+}
+
+bool CaptureFormat::choose(const std::vector<CaptureMode>& modes, const CaptureRequirement& requirement,
+                           CaptureMode& chosen)
+{
+    const CaptureMode* best = nullptr;
+    const CaptureMode* largest = nullptr;
+    for (const CaptureMode& mode : modes) {
+        const double modeCost = cost(mode);
+        if (modeCost < 0.0) {
+            continue;
+        }
+        // 设备未报告帧率时按达标处理
+        if (mode.fps > 0.0 && mode.fps + 0.5 < requirement.minFps) {
+            continue;
+        }
+
+        // 帧宽或帧高达到模型输入时 letterbox 缩放系数不大于 1，不会因分辨率不足丢失细节
+        const bool coversModel = mode.width >= requirement.modelWidth
+                                 || mode.height >= requirement.modelHeight;
+        if (coversModel) {
+            if (!best || modeCost < cost(*best) || (modeCost == cost(*best) && mode.fps > best->fps)) {
+                best = &mode;
+            }
+        } else if (!largest || mode.width * mode.height > largest->width * largest->height
+                   || (mode.width * mode.height == largest->width * largest->height
+                       && modeCost < cost(*largest))) {
+            largest = &mode;
+        }
+    }
+
+    if (!best) {
+        best = largest;
+    }
+    if (!best) {
+        return false;
+    }
+    chosen = *best;
+    return true;
+}
+
+bool CaptureFormat::open(cv::VideoCapture& capture, int deviceId, const CaptureMode& mode, bool rawYuv)
+{
+    if (!capture.open(deviceId, cv::CAP_V4L2)) {
+        return false;
+    }
+
+    // 先设格式再设尺寸和帧率，V4L2 后端每次设置都会重新协商
+    capture.set(cv::CAP_PROP_FOURCC, static_cast<double>(mode.fourcc));
+    capture.set(cv::CAP_PROP_FRAME_WIDTH, mode.width);
+    capture.set(cv::CAP_PROP_FRAME_HEIGHT, mode.height);
+    if (mode.fps > 0.0) {
+        capture.set(cv::CAP_PROP_FPS, mode.fps);
+    }
+    if (rawYuv && mode.fourcc == kYUYV) {
+        capture.set(cv::CAP_PROP_CONVERT_RGB, 0);
+    }
+
+    const uint32_t actualFourcc = static_cast<uint32_t>(capture.get(cv::CAP_PROP_FOURCC));
+    const int actualWidth = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH));
+    const int actualHeight = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+    if (actualFourcc != mode.fourcc || actualWidth != mode.width || actualHeight != mode.height) {
+        qDebug() << "Capture format: requested" << QString::fromStdString(fourccName(mode.fourcc))
+                 << mode.width << "x" << mode.height << "but device delivers"
+                 << QString::fromStdString(fourccName(actualFourcc)) << actualWidth << "x" << actualHeight;
+    }
+    return true;
+}
+
+bool CaptureFormat::deliversRawYuyv(const cv::VideoCapture& capture)
+{
+    return capture.isOpened()
+           && static_cast<uint32_t>(capture.get(cv::CAP_PROP_FOURCC)) == kYUYV
+           && capture.get(cv::CAP_PROP_CONVERT_RGB) == 0.0;
+}
+
+std::string CaptureFormat::fourccName(uint32_t fourcc)
+{
+    std::string name(4, ' ');
+    for (int i = 0; i < 4; ++i) {
+        const char c = static_cast<char>((fourcc >> (8 * i)) & 0xFF);
+        name[i] = (c >= 32 && c < 127) ? c : '?';
+    }
+    return name;
+}
@@ -0,0 +1,50 @@
+#ifndef CAPTUREFORMAT_H
+#define CAPTUREFORMAT_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 摄像头支持的一种采集模式
+struct CaptureMode {
+    uint32_t fourcc = 0;
+    int width = 0;
+    int height = 0;
+    double fps = 0.0;           // 该尺寸下的最高帧率，0 表示设备未报告
+};
+
+// 采集需求：检测模型的输入尺寸和最低帧率
+struct CaptureRequirement {
+    int modelWidth = 640;
+    int modelHeight = 640;
+    double minFps = 15.0;
+};
+
+// 采集格式协商：枚举设备支持的模式，选出满足需求且每帧代价最低的一种。
+// 模式枚举目前只支持 Linux V4L2，其他平台返回空列表，由后端按默认格式打开
+class CaptureFormat
+{
+public:
+    // 枚举 /dev/video<deviceId> 支持的 格式 × 尺寸 组合
+    static std::vector<CaptureMode> probe(int deviceId);
+
+    // 帧尺寸不小于模型输入（letterbox 无需放大）且帧率达标的模式中选代价最低的；
+    // 没有满足的模式时退而选帧率达标的最大尺寸。modes 为空时返回 false
+    static bool choose(const std::vector<CaptureMode>& modes, const CaptureRequirement& requirement,
+                       CaptureMode& chosen);
+
+    // 相对每帧代价：像素数 × 格式系数（YUYV 直接进预处理最低，MJPG 需要 JPEG 解码最高），
+    // 不支持的格式返回负数
+    static double cost(const CaptureMode& mode);
+
+    // 以 V4L2 后端按指定模式打开设备。rawYuv 为 true 且格式为 YUYV 时关闭后端的 RGB 转换，
+    // 帧以 CV_8UC2 交给预处理直接转换
+    static bool open(cv::VideoCapture& capture, int deviceId, const CaptureMode& mode, bool rawYuv);
+    // 后端是否输出未经转换的 YUYV 帧
+    static bool deliversRawYuyv(const cv::VideoCapture& capture);
+
+    static std::string fourccName(uint32_t fourcc);
+};
+
+#endif // CAPTUREFORMAT_H
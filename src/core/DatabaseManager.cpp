@@ -5,6 +5,19 @@
 #include <QDebug>
 #include <QVariant>
 
+namespace {
+
+const char* const kCreateTableQuery = R"(
+        CREATE TABLE IF NOT EXISTS detection_results (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            timestamp DATETIME NOT NULL,
+            detection_type TEXT NOT NULL,
+            confidence REAL NOT NULL
+        )
+    )";
+
+} // namespace
+
 DatabaseManager::DatabaseManager(const std::string& dbPath)
     : m_dbPath(dbPath)
 {
@@ -33,16 +46,30 @@ bool DatabaseManager::initDatabase()
 
 bool DatabaseManager::createTables()
 {
-    QString createTableQuery = R"(
-        CREATE TABLE IF NOT EXISTS detection_results (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            timestamp DATETIME NOT NULL,
-            detection_type TEXT NOT NULL,
-            confidence REAL NOT NULL
-        )
-    )";
+    return executeQuery(kCreateTableQuery);
+}
 
-    return executeQuery(createTableQuery);
+bool DatabaseManager::migrate(const std::string& dbPath)
+{
+    // QSqlDatabase 连接只能在创建它的线程中使用，这里用独立的命名连接，用完即删
+    const QString connectionName = "startup_migration";
+    bool success = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(QString::fromStdString(dbPath));
+        if (!db.open()) {
+            qDebug() << "Migration failed to open database:" << db.lastError().text();
+        } else {
+            QSqlQuery query(db);
+            success = query.exec(kCreateTableQuery);
+            if (!success) {
+                qDebug() << "Migration failed:" << query.lastError().text();
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return success;
 }
 
 bool DatabaseManager::executeQuery(const QString& query)
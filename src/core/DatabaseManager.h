@@ -20,6 +20,9 @@ public:
     explicit DatabaseManager(const std::string& dbPath);
     ~DatabaseManager();
 
+    // 建表/迁移：使用独立连接，可在后台线程调用；完成后主线程构造 DatabaseManager 只需打开文件
+    static bool migrate(const std::string& dbPath);
+
     // 数据库操作
     bool initDatabase();
     bool saveDetection(const std::string& detectionType, double confidence);
@@ -1,20 +1,24 @@
 #include "DetectionEngine.h"
+#include "YoloDecoder.h"
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <QDebug>
+#include <QElapsedTimer>
 
-DetectionEngine::DetectionEngine()
-    : m_modelLoaded(false)
+DetectionEngine::DetectionEngine(std::shared_ptr<EngineFactory> factory)
+    : m_factory(std::move(factory))
+    , m_intraOpThreads(1)
+    , m_regionInputSize(320)
     , m_confThreshold(0.5f)
     , m_nmsThreshold(0.45f)
-    , m_inputWidth(640)
-    , m_inputHeight(640)
+    , m_nmsTopK(300)
 {
-    // 初始化ONNX Runtime环境
-    m_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "DetectionEngine");
-    m_sessionOptions = std::make_unique<Ort::SessionOptions>();
-    m_sessionOptions->SetIntraOpNumThreads(4);
-    m_sessionOptions->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+    // 初始化ONNX Runtime环境（Env、线程池、分配器由工厂统一管理）
+    if (!m_factory) {
+        m_factory = std::make_shared<EngineFactory>();
+    }
+    m_intraOpThreads = m_factory->options().intraOpThreads;
 
     m_memoryInfo = std::make_unique<Ort::MemoryInfo>(
         Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault));
@@ -32,291 +36,609 @@ void DetectionEngine::initClassNames()
         "biyanjing",     // 打哈欠
         "normal"        // 正常
     };
+
+    // 默认含义按上面的注释；类别名的拼音与注释相反，尚未用标注文件核实，可由 setClassRoles() 改正。
+    // 疲劳判定、状态分类器等通过 classRoles() 取得
+    m_classRoles.eyesClosed = 0;
+    m_classRoles.yawn = 1;
+    m_classRoles.normal = 2;
 }
 
-bool DetectionEngine::loadModel(const std::string& modelPath)
+void DetectionEngine::setClassRoles(const ClassRoles& roles)
 {
-    try {
-        qDebug() << "--------------";
-        qDebug() << "Initializing ONNX Runtime environment...";
-        qDebug() << "--------------";
-        qDebug() << QString::fromStdString(modelPath) << "--------------";
+    const int classCount = static_cast<int>(m_classNames.size());
+    auto valid = [classCount](int classId) { return classId >= 0 && classId < classCount; };
+    if (!valid(roles.eyesClosed) || !valid(roles.yawn) || !valid(roles.normal)
+        || roles.eyesClosed == roles.yawn || roles.eyesClosed == roles.normal
+        || roles.yawn == roles.normal) {
+        qDebug() << "Invalid class roles: eyes closed" << roles.eyesClosed << ", yawn" << roles.yawn
+                 << ", normal" << roles.normal << "- keeping" << m_classRoles.eyesClosed << "/"
+                 << m_classRoles.yawn << "/" << m_classRoles.normal;
+        return;
+    }
+    m_classRoles = roles;
+}
 
-        // 创建ONNX Runtime会话
-        // m_session = std::make_unique<Ort::Session>(*m_env, modelPath.c_str(), *m_sessionOptions);
-        QString qstr = QString::fromStdString(modelPath); // std::string -> QString
-        // 1. 转换为 std::wstring
-        std::wstring modelPathW = qstr.toStdWString();
-        // 显示模型路径
-        qDebug() << modelPath << "--------------";
-        qDebug() << modelPathW << "--------------";
-
-        // 2. 使用 std::wstring::c_str()
-        m_session = std::make_unique<Ort::Session>(*m_env, modelPathW.c_str(), *m_sessionOptions);
-
-        // 获取输入信息
-        Ort::AllocatorWithDefaultOptions allocator;
-        size_t numInputNodes = m_session->GetInputCount();
-
-        if (numInputNodes != 1) {
-            qDebug() << "Model should have exactly 1 input, but has" << numInputNodes;
-            return false;
-        }
+bool DetectionEngine::supportsDynamicBatch() const
+{
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    return slot && slot->dynamicBatch;
+}
 
-        // 获取输入维度
-        Ort::TypeInfo inputTypeInfo = m_session->GetInputTypeInfo(0);
-        auto inputTensorInfo = inputTypeInfo.GetTensorTypeAndShapeInfo();
-        m_inputShape = inputTensorInfo.GetShape();
+size_t DetectionEngine::getResidentMemoryDelta() const
+{
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    return slot ? slot->residentMemoryDelta : 0;
+}
 
-        if (m_inputShape.size() != 4) {
-            qDebug() << "Expected 4D input tensor";
-            return false;
-        }
+bool DetectionEngine::supportsRegionInput() const
+{
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    return slot && slot->region;
+}
 
-        m_inputHeight = static_cast<int>(m_inputShape[2]);
-        m_inputWidth = static_cast<int>(m_inputShape[3]);
-        m_inputSize = std::accumulate(m_inputShape.begin(), m_inputShape.end(),
-                                      1, std::multiplies<int64_t>());
+void DetectionEngine::setRegionInput(int inputSize, const std::string& modelPath)
+{
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    m_regionInputSize = inputSize;
+    m_regionModelPath = modelPath;
+}
 
-        // 获取输出信息
-        size_t numOutputNodes = m_session->GetOutputCount();
-        if (numOutputNodes != 1) {
-            qDebug() << "Model should have exactly 1 output, but has" << numOutputNodes;
-            return false;
-        }
+bool DetectionEngine::supportsStateClassifier() const
+{
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    return slot && (slot->eyeClassifier || slot->mouthClassifier);
+}
 
-        Ort::TypeInfo outputTypeInfo = m_session->GetOutputTypeInfo(0);
-        auto outputTensorInfo = outputTypeInfo.GetTensorTypeAndShapeInfo();
-        m_outputShape = outputTensorInfo.GetShape();
-        m_outputSize = std::accumulate(m_outputShape.begin(), m_outputShape.end(),
-                                       1, std::multiplies<int64_t>());
+void DetectionEngine::setStateClassifiers(const std::string& eyeModelPath,
+                                          const std::string& mouthModelPath)
+{
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    m_eyeModelPath = eyeModelPath;
+    m_mouthModelPath = mouthModelPath;
+}
 
-        m_modelLoaded = true;
-        qDebug() << QString::fromStdString(modelPath) << "--------------";
-        qDebug() << "Model loaded successfully";
-        qDebug() << "Input shape:" << m_inputShape[0] << m_inputShape[1]
-                 << m_inputShape[2] << m_inputShape[3];
-        qDebug() << "Output shape:" << m_outputShape[0] << m_outputShape[1]
-                 << m_outputShape[2];
+cv::Size DetectionEngine::getInputSize() const
+{
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    return slot ? cv::Size(slot->inputWidth, slot->inputHeight) : cv::Size(640, 640);
+}
 
-        return true;
-    } catch (const Ort::Exception& e) {
-        qDebug() << "Failed to load model:" << e.what();
-        m_modelLoaded = false;
+bool DetectionEngine::loadModel(const std::string& modelPath)
+{
+    std::shared_ptr<ModelSlot> slot = prepareModel(modelPath);
+    if (!slot) {
         return false;
     }
+    publishModel(std::move(slot));
+    return true;
 }
 
-std::vector<Detection> DetectionEngine::detect(const cv::Mat& image)
+std::shared_ptr<ModelSlot> DetectionEngine::prepareModel(const std::string& modelPath)
 {
-    std::vector<Detection> results;
-
-    if (!m_modelLoaded || image.empty()) {
-        return results;
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    QElapsedTimer timer;
+    timer.start();
+
+    // 新模型加载到独立的槽中，当前槽在发布前继续服务推理
+    auto slot = std::make_shared<ModelSlot>();
+    slot->modelPath = modelPath;
+    if (std::shared_ptr<ModelSlot> current = currentSlot()) {
+        slot->inputWidth = current->inputWidth;
+        slot->inputHeight = current->inputHeight;
     }
 
     try {
-        // 记录原始图像尺寸
-        cv::Size originalSize = image.size();
-        qDebug() << "Original Frame Size:" << originalSize.width << "x" << originalSize.height;
-
-        // 预处理
-        cv::Mat processedImage = preprocess(image);
-
-        // 准备输入数据
-        std::vector<float> inputData(m_inputSize);
-        cv::Mat floatImage;
-        processedImage.convertTo(floatImage, CV_32F, 1.0 / 255.0);
-
-        // HWC to CHW
-        std::vector<cv::Mat> channels(3);
-        cv::split(floatImage, channels);
-        for (int c = 0; c < 3; ++c) {
-            std::memcpy(inputData.data() + c * m_inputHeight * m_inputWidth,
-                        channels[c].data,
-                        m_inputHeight * m_inputWidth * sizeof(float));
+        qDebug() << "--------------";
+        qDebug() << QString::fromStdString(modelPath) << "--------------";
+
+        // 创建ONNX Runtime会话，记录会话占用的常驻内存
+        const size_t residentBefore = EngineFactory::residentMemoryBytes();
+        slot->session = m_factory->createSession(modelPath);
+        const double sessionMs = timer.nsecsElapsed() / 1e6;
+
+        if (!bindSlot(*slot)) {
+            return nullptr;
         }
+        bindRegion(*slot);
+        bindClassifiers(*slot);
+        const double bindMs = timer.nsecsElapsed() / 1e6;
 
-        // 创建输入张量
-        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-            *m_memoryInfo, inputData.data(), inputData.size(),
-            m_inputShape.data(), m_inputShape.size());
+        // 预热：首次 Run 会触发内核选择和内存分配，放在发布前完成，避免切换后第一帧卡顿
+        warmUp(*slot);
 
-        // 运行推理
-        // const char* inputName = m_session->GetInputName(0, Ort::AllocatorWithDefaultOptions());
-        // const char* outputName = m_session->GetOutputName(0, Ort::AllocatorWithDefaultOptions());
+        const size_t residentAfter = EngineFactory::residentMemoryBytes();
+        slot->residentMemoryDelta = residentAfter > residentBefore ? residentAfter - residentBefore : 0;
 
-        // 运行推理
-        // 获取默认分配器
-        // Ort::AllocatorWithDefaultOptions allocator;
+        qDebug() << "Model prepared: session" << sessionMs << "ms, bind"
+                 << bindMs - sessionMs << "ms, warm-up"
+                 << timer.nsecsElapsed() / 1e6 - bindMs << "ms";
+        qDebug() << "Input shape:" << slot->inputShape[0] << slot->inputShape[1]
+                 << slot->inputShape[2] << slot->inputShape[3];
+        qDebug() << "Output shape:" << slot->outputShape[0] << slot->outputShape[1]
+                 << slot->outputShape[2];
 
-        // 获取输入名称
-        Ort::AllocatedStringPtr inputNamePtr = m_session->GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
-        const char* inputName = inputNamePtr.get();
+        return slot;
+    } catch (const Ort::Exception& e) {
+        qDebug() << "Failed to load model:" << e.what();
+        return nullptr;
+    }
+}
 
-        // 获取输出名称
-        Ort::AllocatedStringPtr outputNamePtr = m_session->GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
-        const char* outputName = outputNamePtr.get();
+void DetectionEngine::publishModel(std::shared_ptr<ModelSlot> slot)
+{
+    // 原子替换；正在推理的线程仍持有旧槽，用完后旧会话随最后一个引用释放
+    std::atomic_store(&m_slot, std::move(slot));
+}
 
-        auto outputTensors = m_session->Run(Ort::RunOptions{nullptr},
-                                            &inputName, &inputTensor, 1,
-                                            &outputName, 1);
+bool DetectionEngine::bindSlot(ModelSlot& slot)
+{
+    Ort::Session& session = *slot.session;
 
-        // 获取输出数据
-        float* outputData = outputTensors[0].GetTensorMutableData<float>();
-        std::vector<float> output(outputData, outputData + m_outputSize);
+    // 获取输入信息
+    Ort::AllocatorWithDefaultOptions allocator;
+    size_t numInputNodes = session.GetInputCount();
 
-        // 后处理 - 专门处理 [1, 7, 8400] 格式
-        results = postprocessCustomFormat(output, originalSize);
+    if (numInputNodes != 1) {
+        qDebug() << "Model should have exactly 1 input, but has" << numInputNodes;
+        return false;
+    }
 
-    } catch (const Ort::Exception& e) {
-        qDebug() << "Detection failed:" << e.what();
+    // 获取输入维度
+    Ort::TypeInfo inputTypeInfo = session.GetInputTypeInfo(0);
+    auto inputTensorInfo = inputTypeInfo.GetTensorTypeAndShapeInfo();
+    slot.inputShape = inputTensorInfo.GetShape();
+
+    if (slot.inputShape.size() != 4) {
+        qDebug() << "Expected 4D input tensor";
+        return false;
     }
 
-    return results;
+    // 动态维度：batch 默认按 1 分配，宽高沿用当前输入尺寸
+    slot.dynamicBatch = slot.inputShape[0] <= 0;
+    slot.dynamicSpatial = slot.inputShape[2] <= 0 || slot.inputShape[3] <= 0;
+    if (slot.dynamicBatch) {
+        slot.inputShape[0] = 1;
+    }
+    if (slot.inputShape[2] > 0) {
+        slot.inputHeight = static_cast<int>(slot.inputShape[2]);
+    } else {
+        slot.inputShape[2] = slot.inputHeight;
+    }
+    if (slot.inputShape[3] > 0) {
+        slot.inputWidth = static_cast<int>(slot.inputShape[3]);
+    } else {
+        slot.inputShape[3] = slot.inputWidth;
+    }
+    slot.inputSize = std::accumulate(slot.inputShape.begin(), slot.inputShape.end(),
+                                     int64_t(1), std::multiplies<int64_t>());
+
+    // 获取输出信息
+    size_t numOutputNodes = session.GetOutputCount();
+    if (numOutputNodes != 1) {
+        qDebug() << "Model should have exactly 1 output, but has" << numOutputNodes;
+        return false;
+    }
+
+    Ort::TypeInfo outputTypeInfo = session.GetOutputTypeInfo(0);
+    auto outputTensorInfo = outputTypeInfo.GetTensorTypeAndShapeInfo();
+    slot.outputShape = outputTensorInfo.GetShape();
+    if (!slot.outputShape.empty() && slot.outputShape[0] <= 0) {
+        slot.outputShape[0] = 1;
+    }
+    slot.staticOutput = std::all_of(slot.outputShape.begin(), slot.outputShape.end(),
+                                    [](int64_t d) { return d > 0; });
+    slot.outputSize = slot.staticOutput
+        ? std::accumulate(slot.outputShape.begin(), slot.outputShape.end(),
+                          int64_t(1), std::multiplies<int64_t>())
+        : 0;
+
+    // 输入输出名称只解析一次
+    slot.inputName = session.GetInputNameAllocated(0, allocator).get();
+    slot.outputName = session.GetOutputNameAllocated(0, allocator).get();
+
+    // 输入输出张量缓冲只在加载模型时分配，并通过 IoBinding 绑定给会话
+    slot.inputBuffer.assign(slot.inputSize, Preprocessor::PAD_VALUE);
+    slot.outputBuffer.assign(slot.outputSize, 0.0f);
+    slot.inputTensor = Ort::Value::CreateTensor<float>(
+        *m_memoryInfo, slot.inputBuffer.data(), slot.inputBuffer.size(),
+        slot.inputShape.data(), slot.inputShape.size());
+
+    slot.ioBinding = std::make_unique<Ort::IoBinding>(session);
+    slot.ioBinding->BindInput(slot.inputName.c_str(), slot.inputTensor);
+    if (slot.staticOutput) {
+        slot.outputTensor = Ort::Value::CreateTensor<float>(
+            *m_memoryInfo, slot.outputBuffer.data(), slot.outputBuffer.size(),
+            slot.outputShape.data(), slot.outputShape.size());
+        slot.ioBinding->BindOutput(slot.outputName.c_str(), slot.outputTensor);
+    } else {
+        // 输出尺寸由输入决定，交给 ORT 分配
+        slot.ioBinding->BindOutput(slot.outputName.c_str(), *m_memoryInfo);
+    }
+    return true;
 }
 
-cv::Mat DetectionEngine::preprocess(const cv::Mat& image)
+std::unique_ptr<SecondaryBinding> DetectionEngine::loadSecondary(const std::string& modelPath,
+                                                                int defaultSize)
 {
-    cv::Mat resized;
-    letterbox(image, resized, cv::Size(m_inputWidth, m_inputHeight));
-    return resized;
+    // 附加模型加载失败只关闭对应功能，不影响主模型
+    auto binding = std::make_unique<SecondaryBinding>();
+    try {
+        binding->session = m_factory->createSession(modelPath);
+    } catch (const Ort::Exception& e) {
+        qDebug() << "Failed to load" << QString::fromStdString(modelPath) << ":" << e.what();
+        return nullptr;
+    }
+
+    Ort::Session& session = *binding->session;
+    const std::vector<int64_t> shape =
+        session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    if (shape.size() != 4 || session.GetOutputCount() != 1) {
+        qDebug() << "Secondary model must have one 4D input and one output:"
+                 << QString::fromStdString(modelPath);
+        return nullptr;
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    binding->inputName = session.GetInputNameAllocated(0, allocator).get();
+    binding->outputName = session.GetOutputNameAllocated(0, allocator).get();
+    bindSecondary(*binding, session, shape, defaultSize);
+    return binding;
 }
 
-void DetectionEngine::letterbox(const cv::Mat& src, cv::Mat& dst, const cv::Size& targetSize)
+void DetectionEngine::bindSecondary(SecondaryBinding& binding, Ort::Session& session,
+                                    std::vector<int64_t> shape, int defaultSize)
 {
-    float scale = std::min(static_cast<float>(targetSize.width) / src.cols,
-                           static_cast<float>(targetSize.height) / src.rows);
+    // 单帧输入，动态宽高取 defaultSize
+    shape[0] = 1;
+    shape[1] = 3;
+    binding.inputHeight = shape[2] > 0 ? static_cast<int>(shape[2]) : defaultSize;
+    binding.inputWidth = shape[3] > 0 ? static_cast<int>(shape[3]) : defaultSize;
+    shape[2] = binding.inputHeight;
+    shape[3] = binding.inputWidth;
+    binding.inputShape = shape;
+    binding.inputBuffer.assign(static_cast<size_t>(3) * binding.inputWidth * binding.inputHeight,
+                               Preprocessor::PAD_VALUE);
+    binding.inputTensor = Ort::Value::CreateTensor<float>(
+        *m_memoryInfo, binding.inputBuffer.data(), binding.inputBuffer.size(),
+        binding.inputShape.data(), binding.inputShape.size());
+
+    binding.ioBinding = std::make_unique<Ort::IoBinding>(session);
+    binding.ioBinding->BindInput(binding.inputName.c_str(), binding.inputTensor);
+    binding.ioBinding->BindOutput(binding.outputName.c_str(), *m_memoryInfo);
+}
 
-    int newWidth = static_cast<int>(src.cols * scale);
-    int newHeight = static_cast<int>(src.rows * scale);
+void DetectionEngine::bindRegion(ModelSlot& slot)
+{
+    if (m_regionInputSize <= 0) {
+        return;
+    }
 
-    cv::Mat scaled;
-    cv::resize(src, scaled, cv::Size(newWidth, newHeight));
+    if (!m_regionModelPath.empty()) {
+        // 单独的小输入模型，类别与主模型一致
+        slot.region = loadSecondary(m_regionModelPath, m_regionInputSize);
+    } else if (slot.dynamicSpatial) {
+        // 主模型宽高为动态维度：同一会话按较小尺寸再绑定一份
+        auto region = std::make_unique<SecondaryBinding>();
+        region->inputName = slot.inputName;
+        region->outputName = slot.outputName;
+        bindSecondary(*region, *slot.session, slot.inputShape, m_regionInputSize);
+        slot.region = std::move(region);
+    }
+    // 固定输入尺寸的模型无法在同一会话上缩小输入，不启用区域推理
 
-    dst = cv::Mat::zeros(targetSize, src.type());
-    dst.setTo(cv::Scalar(114, 114, 114));
+    if (slot.region) {
+        qDebug() << "Region input:" << slot.region->inputWidth << "x" << slot.region->inputHeight
+                 << (slot.region->session ? "(secondary model)" : "(dynamic shape)");
+    }
+}
 
-    int top = (targetSize.height - newHeight) / 2;
-    int left = (targetSize.width - newWidth) / 2;
+void DetectionEngine::bindClassifiers(ModelSlot& slot)
+{
+    if (!m_eyeModelPath.empty()) {
+        slot.eyeClassifier = loadSecondary(m_eyeModelPath, CLASSIFIER_INPUT_SIZE);
+    }
+    if (!m_mouthModelPath.empty()) {
+        slot.mouthClassifier = loadSecondary(m_mouthModelPath, CLASSIFIER_INPUT_SIZE);
+    }
+    if (slot.eyeClassifier || slot.mouthClassifier) {
+        qDebug() << "State classifiers: eye" << (slot.eyeClassifier != nullptr)
+                 << "mouth" << (slot.mouthClassifier != nullptr);
+    }
+}
 
-    scaled.copyTo(dst(cv::Rect(left, top, newWidth, newHeight)));
+void DetectionEngine::warmUp(ModelSlot& slot)
+{
+    // 输入缓冲已填充为 letterbox 底色，直接跑一次
+    slot.session->Run(Ort::RunOptions{nullptr}, *slot.ioBinding);
+    for (SecondaryBinding* binding : {slot.region.get(), slot.eyeClassifier.get(),
+                                      slot.mouthClassifier.get()}) {
+        if (binding) {
+            Ort::Session& session = binding->session ? *binding->session : *slot.session;
+            session.Run(Ort::RunOptions{nullptr}, *binding->ioBinding);
+        }
+    }
 }
 
-std::vector<Detection> DetectionEngine::postprocessCustomFormat(const std::vector<float>& output,
-                                                                const cv::Size& originalSize)
+std::vector<Detection> DetectionEngine::detect(const cv::Mat& image)
 {
-    std::vector<Detection> detections;
+    std::vector<Detection> results;
 
-    // 输出格式: [1, 7, 8400]
-    // 7个值: x_center, y_center, width, height, class1_score, class2_score, class3_score
-    const int numBoxes = 8400;
-    const int numValues = 7;
-
-    float scaleX = static_cast<float>(originalSize.width) / m_inputWidth;
-    float scaleY = static_cast<float>(originalSize.height) / m_inputHeight;
-
-    qDebug() << "Display Frame Size:" << originalSize.width << "x" << originalSize.height;
-
-    for (int i = 0; i < numBoxes; ++i) {
-        // 获取边界框坐标 (前4个值) - 使用转置索引
-        float cx = output[0 * numBoxes + i];  // x_center
-        float cy = output[1 * numBoxes + i];  // y_center
-        float w = output[2 * numBoxes + i];   // width
-        float h = output[3 * numBoxes + i];   // height
-
-        // 获取类别分数 (后3个值)
-        float maxScore = 0;
-        int classId = -1;
-        for (int c = 0; c < 3; ++c) {
-            float score = output[(4 + c) * numBoxes + i];
-            if (score > maxScore) {
-                maxScore = score;
-                classId = c;
-            }
-        }
+    // 整帧持有同一个模型槽，期间发布的新模型从下一帧开始生效
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    if (!slot || image.empty()) {
+        return results;
+    }
 
-        // 应用置信度阈值
-        if (maxScore < m_confThreshold || classId < 0) {
-            continue;
+    try {
+        // 记录原始图像尺寸
+        cv::Size originalSize = image.size();
+
+        // 预处理：letterbox + 归一化 + HWC->CHW 直接写入输入缓冲
+        m_letterbox = m_preprocessor.letterboxToCHW(image, slot->inputBuffer.data(),
+                                                    slot->inputWidth, slot->inputHeight);
+
+        // 运行推理：输入输出已绑定到预分配缓冲
+        slot->session->Run(Ort::RunOptions{nullptr}, *slot->ioBinding);
+
+        // 输出维度固定时直接读取绑定缓冲，否则读取 ORT 分配的输出
+        std::vector<Ort::Value> dynamicOutputs;
+        const float* outputData = slot->outputBuffer.data();
+        std::vector<int64_t> outputShape = slot->outputShape;
+        if (!slot->staticOutput) {
+            dynamicOutputs = slot->ioBinding->GetOutputValues();
+            outputData = dynamicOutputs[0].GetTensorData<float>();
+            outputShape = dynamicOutputs[0].GetTensorTypeAndShapeInfo().GetShape();
         }
 
-        // 将坐标从模型输出空间转换到原始图像空间
-        float x1 = (cx - w / 2.0f) * scaleX;
-        float y1 = (cy - h / 2.0f) * scaleY;
-        float x2 = (cx + w / 2.0f) * scaleX;
-        float y2 = (cy + h / 2.0f) * scaleY;
+        // 后处理：布局由输出维度决定
+        results = postprocess(outputData, outputShape, m_letterbox, originalSize);
 
-        // 限制在图像范围内
-        x1 = std::max(0.0f, x1);
-        y1 = std::max(0.0f, y1);
-        x2 = std::min(static_cast<float>(originalSize.width - 1), x2);
-        y2 = std::min(static_cast<float>(originalSize.height - 1), y2);
+    } catch (const Ort::Exception& e) {
+        qDebug() << "Detection failed:" << e.what();
+    }
 
-        Detection det;
-        det.bbox = cv::Rect(static_cast<int>(x1),
-                            static_cast<int>(y1),
-                            static_cast<int>(x2 - x1),
-                            static_cast<int>(y2 - y1));
-        det.confidence = maxScore;
-        det.classId = classId;
-        det.className = (classId < m_classNames.size()) ? m_classNames[classId] : "unknown";
+    return results;
+}
 
-        detections.push_back(det);
+std::vector<Detection> DetectionEngine::detectRegion(const cv::Mat& image, const cv::Rect& region)
+{
+    std::vector<Detection> results;
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    cv::Rect roi = region & cv::Rect(0, 0, image.cols, image.rows);
+    if (image.type() == CV_8UC2) {
+        // YUYV 两个像素共用一组色度，裁剪起点和宽度取偶数
+        roi.x &= ~1;
+        roi.width &= ~1;
+    }
+    if (!slot || image.empty() || roi.width < 2 || roi.height < 2) {
+        return results;
+    }
 
-        qDebug() << "Detection Box (x,y,w,h):" << det.bbox.x << det.bbox.y
-                 << det.bbox.width << det.bbox.height;
+    const cv::Mat crop = image(roi);
+    SecondaryBinding* binding = slot->region.get();
+    if (!binding) {
+        results = detect(crop);
+    } else {
+        try {
+            const LetterboxInfo letterbox = m_preprocessor.letterboxToCHW(
+                crop, binding->inputBuffer.data(), binding->inputWidth, binding->inputHeight);
+
+            Ort::Session& session = binding->session ? *binding->session : *slot->session;
+            session.Run(Ort::RunOptions{nullptr}, *binding->ioBinding);
+
+            std::vector<Ort::Value> outputs = binding->ioBinding->GetOutputValues();
+            results = postprocess(outputs[0].GetTensorData<float>(),
+                                  outputs[0].GetTensorTypeAndShapeInfo().GetShape(),
+                                  letterbox, crop.size());
+        } catch (const Ort::Exception& e) {
+            qDebug() << "Region detection failed:" << e.what();
+        }
     }
 
-    // 应用NMS
-    return nms(detections);
+    // 裁剪区域坐标 -> 整帧坐标
+    for (Detection& det : results) {
+        det.bbox.x += roi.x;
+        det.bbox.y += roi.y;
+    }
+    return results;
 }
 
-std::vector<Detection> DetectionEngine::postprocess(const std::vector<float>& output,
-                                                    const cv::Size& originalSize)
+int DetectionEngine::classifyState(const cv::Mat& image, const cv::Rect2f& face, float& score)
 {
-    // 这个函数现在调用专门的处理函数
-    return postprocessCustomFormat(output, originalSize);
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    if (!slot || (!slot->eyeClassifier && !slot->mouthClassifier) || image.empty()) {
+        return -1;
+    }
+
+    // 人脸框内的眼部、嘴部区域（按检测框比例，不依赖关键点）
+    auto band = [&face](float left, float top, float right, float bottom) {
+        return cv::Rect(cvRound(face.x + face.width * left), cvRound(face.y + face.height * top),
+                        cvRound(face.width * (right - left)), cvRound(face.height * (bottom - top)));
+    };
+
+    float eyesClosed = 0.0f;
+    float yawning = 0.0f;
+    try {
+        if (slot->eyeClassifier) {
+            eyesClosed = runClassifier(*slot->eyeClassifier, image, band(0.1f, 0.15f, 0.9f, 0.55f));
+        }
+        if (slot->mouthClassifier) {
+            yawning = runClassifier(*slot->mouthClassifier, image, band(0.2f, 0.55f, 0.8f, 1.0f));
+        }
+    } catch (const Ort::Exception& e) {
+        qDebug() << "State classification failed:" << e.what();
+        return -1;
+    }
+
+    // 两个状态都成立时取概率高的一个
+    if (eyesClosed >= 0.5f || yawning >= 0.5f) {
+        score = std::max(eyesClosed, yawning);
+        return eyesClosed >= yawning ? m_classRoles.eyesClosed : m_classRoles.yawn;
+    }
+    score = 1.0f - std::max(eyesClosed, yawning);
+    return m_classRoles.normal;
 }
 
-std::vector<Detection> DetectionEngine::nms(std::vector<Detection>& detections)
+float DetectionEngine::runClassifier(SecondaryBinding& binding, const cv::Mat& image,
+                                     const cv::Rect& region)
 {
-    if (detections.empty()) {
-        return detections;
+    cv::Rect roi = region & cv::Rect(0, 0, image.cols, image.rows);
+    if (image.type() == CV_8UC2) {
+        roi.x &= ~1;
+        roi.width &= ~1;
+    }
+    if (roi.width < 2 || roi.height < 2) {
+        return 0.0f;
     }
 
-    std::sort(detections.begin(), detections.end(),
-              [](const Detection& a, const Detection& b) {
-                  return a.confidence > b.confidence;
-              });
+    // 与检测共用预处理器的缩放和颜色转换缓冲
+    m_preprocessor.letterboxToCHW(image(roi), binding.inputBuffer.data(),
+                                  binding.inputWidth, binding.inputHeight);
+    binding.session->Run(Ort::RunOptions{nullptr}, *binding.ioBinding);
 
-    std::vector<Detection> result;
-    std::vector<bool> suppressed(detections.size(), false);
+    std::vector<Ort::Value> outputs = binding.ioBinding->GetOutputValues();
+    const float* logits = outputs[0].GetTensorData<float>();
+    const size_t count = outputs[0].GetTensorTypeAndShapeInfo().GetElementCount();
+    if (count == 1) {
+        return 1.0f / (1.0f + std::exp(-logits[0]));
+    }
+    if (count >= 2) {
+        // 两类 softmax 的下标 1
+        return 1.0f / (1.0f + std::exp(logits[0] - logits[1]));
+    }
+    return 0.0f;
+}
 
-    for (size_t i = 0; i < detections.size(); ++i) {
-        if (suppressed[i]) {
-            continue;
+std::vector<std::vector<Detection>> DetectionEngine::detectBatch(const std::vector<cv::Mat>& images)
+{
+    std::vector<std::vector<Detection>> results(images.size());
+
+    std::shared_ptr<ModelSlot> slot = currentSlot();
+    if (!slot || images.empty()) {
+        return results;
+    }
+
+    // 单帧或固定 batch 的模型无法打包，逐帧推理
+    if (images.size() == 1 || !slot->dynamicBatch) {
+        for (size_t i = 0; i < images.size(); ++i) {
+            results[i] = detect(images[i]);
         }
+        return results;
+    }
 
-        result.push_back(detections[i]);
+    try {
+        const int64_t batch = static_cast<int64_t>(images.size());
+        const int inputWidth = slot->inputWidth;
+        const int inputHeight = slot->inputHeight;
+        const size_t frameInputSize = static_cast<size_t>(3) * inputWidth * inputHeight;
+        if (m_batchInputBuffer.size() < batch * frameInputSize) {
+            m_batchInputBuffer.resize(batch * frameInputSize);
+        }
+        m_batchLetterbox.resize(images.size());
 
-        for (size_t j = i + 1; j < detections.size(); ++j) {
-            if (suppressed[j]) {
+        // 各帧 letterbox 后依次写入 NCHW 张量
+        for (size_t i = 0; i < images.size(); ++i) {
+            float* frameInput = m_batchInputBuffer.data() + i * frameInputSize;
+            if (images[i].empty()) {
+                std::fill(frameInput, frameInput + frameInputSize, Preprocessor::PAD_VALUE);
                 continue;
             }
+            m_batchLetterbox[i] = m_preprocessor.letterboxToCHW(images[i], frameInput,
+                                                                inputWidth, inputHeight);
+        }
 
-            cv::Rect intersection = detections[i].bbox & detections[j].bbox;
-            float intersectionArea = intersection.area();
-            float unionArea = detections[i].bbox.area() + detections[j].bbox.area() - intersectionArea;
+        const int64_t inputShape[4] = {batch, 3, inputHeight, inputWidth};
+        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+            *m_memoryInfo, m_batchInputBuffer.data(), batch * frameInputSize,
+            inputShape, 4);
+
+        const char* inputName = slot->inputName.c_str();
+        const char* outputName = slot->outputName.c_str();
+        std::vector<Ort::Value> dynamicOutputs;
+        const float* outputData = nullptr;
+        size_t frameOutputSize = slot->outputSize;
+        std::vector<int64_t> frameOutputShape = slot->outputShape;
+
+        if (slot->staticOutput) {
+            if (m_batchOutputBuffer.size() < batch * slot->outputSize) {
+                m_batchOutputBuffer.resize(batch * slot->outputSize);
+            }
+            std::vector<int64_t> outputShape = slot->outputShape;
+            outputShape[0] = batch;
+            Ort::Value outputTensor = Ort::Value::CreateTensor<float>(
+                *m_memoryInfo, m_batchOutputBuffer.data(), batch * slot->outputSize,
+                outputShape.data(), outputShape.size());
+            slot->session->Run(Ort::RunOptions{nullptr},
+                               &inputName, &inputTensor, 1,
+                               &outputName, &outputTensor, 1);
+            outputData = m_batchOutputBuffer.data();
+        } else {
+            dynamicOutputs = slot->session->Run(Ort::RunOptions{nullptr},
+                                                &inputName, &inputTensor, 1,
+                                                &outputName, 1);
+            auto info = dynamicOutputs[0].GetTensorTypeAndShapeInfo();
+            frameOutputSize = info.GetElementCount() / batch;
+            frameOutputShape = info.GetShape();
+            frameOutputShape[0] = 1;
+            outputData = dynamicOutputs[0].GetTensorData<float>();
+        }
 
-            if (unionArea > 0) {
-                float iou = intersectionArea / unionArea;
-                if (iou > m_nmsThreshold) {
-                    suppressed[j] = true;
-                }
+        // 按帧拆分输出
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (images[i].empty()) {
+                continue;
             }
+            results[i] = postprocess(outputData + i * frameOutputSize, frameOutputShape,
+                                     m_batchLetterbox[i], images[i].size());
         }
+    } catch (const Ort::Exception& e) {
+        qDebug() << "Batch detection failed:" << e.what();
+    }
+
+    return results;
+}
+
+std::vector<Detection> DetectionEngine::postprocess(const float* output,
+                                                    const std::vector<int64_t>& outputShape,
+                                                    const LetterboxInfo& letterbox,
+                                                    const cv::Size& originalSize)
+{
+    std::vector<Detection> detections;
+
+    // 解码：输出格式如 [1, 7, 8400]，7个值为 x_center, y_center, width, height + 3个类别分数
+    if (!YoloDecoder::decode(output, outputShape, m_confThreshold, m_candidates)) {
+        qDebug() << "Unsupported output shape, dims:" << outputShape.size();
+        return detections;
+    }
+
+    // 按类别 NMS，只对保留下来的框做坐标映射和类别名填充
+    m_nms.run(m_candidates, m_nmsThreshold, m_nmsTopK, m_keep);
+
+    detections.reserve(m_keep.size());
+    for (int index : m_keep) {
+        const DecodedBox& box = m_candidates[index];
+
+        // 按 letterbox 逆映射（去掉填充偏移再除以缩放）回到原始图像空间，并限制在图像范围内
+        float x1 = std::max(0.0f, letterbox.toSourceX(box.x1));
+        float y1 = std::max(0.0f, letterbox.toSourceY(box.y1));
+        float x2 = std::min(static_cast<float>(originalSize.width - 1), letterbox.toSourceX(box.x2));
+        float y2 = std::min(static_cast<float>(originalSize.height - 1), letterbox.toSourceY(box.y2));
+        if (x2 <= x1 || y2 <= y1) {
+            continue;   // 完全落在填充区域内
+        }
+
+        Detection det;
+        det.bbox = cv::Rect(static_cast<int>(x1),
+                            static_cast<int>(y1),
+                            static_cast<int>(x2 - x1),
+                            static_cast<int>(y2 - y1));
+        det.confidence = box.score;
+        det.classId = box.classId;
+        det.className = (box.classId < static_cast<int>(m_classNames.size()))
+                            ? m_classNames[box.classId] : "unknown";
+        detections.push_back(std::move(det));
     }
 
-    return result;
+    return detections;
 }
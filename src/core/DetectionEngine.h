@@ -4,8 +4,14 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 #include <onnxruntime_cxx_api.h>
+#include "EngineFactory.h"
+#include "FrameResult.h"
+#include "Preprocessor.h"
+#include "YoloDecoder.h"
+#include "NonMaxSuppression.h"
 
 struct Detection {
     cv::Rect bbox;
@@ -14,60 +20,164 @@ struct Detection {
     std::string className;
 };
 
+// 附加的单帧输入绑定：区域推理（主模型按较小尺寸再绑定一份，或单独的小输入模型）
+// 和眼部/嘴部状态分类器。输出尺寸随输入和模型变化，交给 ORT 分配
+struct SecondaryBinding {
+    std::unique_ptr<Ort::Session> session;     // 为空时使用主模型的会话
+    std::string inputName;
+    std::string outputName;
+    int inputWidth = 320;
+    int inputHeight = 320;
+    std::vector<int64_t> inputShape;
+    std::vector<float> inputBuffer;
+    Ort::Value inputTensor{nullptr};
+    std::unique_ptr<Ort::IoBinding> ioBinding;
+};
+
+// 模型槽：一次加载产生的会话及其形状、名称和绑定缓冲
+// 推理开始时取出当前槽的 shared_ptr，整帧使用同一个槽；替换模型时发布新槽，
+// 旧槽在最后一个持有它的推理结束后自动释放
+struct ModelSlot {
+    std::string modelPath;
+    std::unique_ptr<Ort::Session> session;
+
+    std::vector<int64_t> inputShape;
+    std::vector<int64_t> outputShape;
+    size_t inputSize = 0;
+    size_t outputSize = 0;
+    int inputWidth = 640;
+    int inputHeight = 640;
+    bool dynamicBatch = false;   // 输入 batch 维为动态
+    bool dynamicSpatial = false; // 输入宽高为动态
+    bool staticOutput = true;    // 输出维度（batch 除外）均为固定值，可预分配
+    size_t residentMemoryDelta = 0;
+
+    // 推理输入输出：名称缓存 + 预分配张量，通过 IoBinding 逐帧复用
+    // 声明顺序保证析构时绑定先于张量、张量先于缓冲和会话释放
+    std::string inputName;
+    std::string outputName;
+    std::vector<float> inputBuffer;
+    std::vector<float> outputBuffer;
+    Ort::Value inputTensor{nullptr};
+    Ort::Value outputTensor{nullptr};
+    std::unique_ptr<Ort::IoBinding> ioBinding;
+    std::unique_ptr<SecondaryBinding> region;           // 不支持较小输入时为空
+    std::unique_ptr<SecondaryBinding> eyeClassifier;    // 未配置时为空
+    std::unique_ptr<SecondaryBinding> mouthClassifier;
+};
+
 class DetectionEngine
 {
 public:
-    DetectionEngine();
+    // factory 为空时使用默认配置自行创建；多个引擎应由同一工厂创建以共享资源
+    explicit DetectionEngine(std::shared_ptr<EngineFactory> factory = nullptr);
     ~DetectionEngine();
 
-    // 模型管理
+    // 模型管理：加载可与 detect() 并发，新模型预热完成后在两帧之间原子替换
     bool loadModel(const std::string& modelPath);
-    bool isModelLoaded() const { return m_modelLoaded; }
+    bool isModelLoaded() const { return currentSlot() != nullptr; }
+
+    // 分两步替换：先在后台创建并预热新槽，再发布；引擎池借此让所有引擎同时切换
+    std::shared_ptr<ModelSlot> prepareModel(const std::string& modelPath);
+    void publishModel(std::shared_ptr<ModelSlot> slot);
 
     // 检测功能
     std::vector<Detection> detect(const cv::Mat& image);
+    // 只在 region 内推理，框映射回整帧坐标。模型支持较小的区域输入时按该尺寸推理，
+    // 否则按主输入尺寸推理裁剪区域（更清晰但不更快）
+    std::vector<Detection> detectRegion(const cv::Mat& image, const cv::Rect& region);
+    bool supportsRegionInput() const;
+    // 区域推理的输入边长和可选的小输入模型，下次加载模型时生效
+    void setRegionInput(int inputSize, const std::string& modelPath);
+    // 级联的第二级：用眼部、嘴部分类器判断 face 框内人脸的状态，返回检测模型的类别 ID
+    // （闭眼/哈欠/正常），score 为该状态的概率。未加载分类器时返回 -1
+    int classifyState(const cv::Mat& image, const cv::Rect2f& face, float& score);
+    bool supportsStateClassifier() const;
+    // 眼部、嘴部分类器模型路径，空表示不使用，下次加载模型时生效。
+    // 分类器输入与检测模型相同的预处理（BGR、1/255、letterbox），
+    // 输出 1 个 logit 或 2 类 logit（下标 1 为闭眼/张嘴）
+    void setStateClassifiers(const std::string& eyeModelPath, const std::string& mouthModelPath);
+    // 多帧打包为一个 NCHW 张量推理，结果按输入顺序返回；固定 batch 的模型逐帧推理
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat>& images);
+    bool supportsDynamicBatch() const;
+    int getIntraOpThreads() const { return m_intraOpThreads; }
+    // 加载模型前后进程常驻内存的增量（字节）
+    size_t getResidentMemoryDelta() const;
 
     // 配置
     void setConfidenceThreshold(float threshold) { m_confThreshold = threshold; }
     void setNMSThreshold(float threshold) { m_nmsThreshold = threshold; }
+    void setNMSTopK(int topK) { m_nmsTopK = topK; }
     float getConfidenceThreshold() const { return m_confThreshold; }
     float getNMSThreshold() const { return m_nmsThreshold; }
 
     // 类别名称
     std::vector<std::string> getClassNames() const { return m_classNames; }
+    // 闭眼、哈欠、正常对应的类别 ID
+    ClassRoles classRoles() const { return m_classRoles; }
+    // 改正类别含义，须在开始推理前调用；ID 越界或重复时保留原值
+    void setClassRoles(const ClassRoles& roles);
+    // 当前模型的输入尺寸
+    cv::Size getInputSize() const;
 
 private:
     // ONNX Runtime相关
-    std::unique_ptr<Ort::Env> m_env;
-    std::unique_ptr<Ort::SessionOptions> m_sessionOptions;
-    std::unique_ptr<Ort::Session> m_session;
+    std::shared_ptr<EngineFactory> m_factory;
     std::unique_ptr<Ort::MemoryInfo> m_memoryInfo;
+    int m_intraOpThreads;
+
+    // 当前模型槽，只通过 std::atomic_load/atomic_store 访问
+    std::shared_ptr<ModelSlot> m_slot;
+    std::mutex m_loadMutex;     // 串行化同一引擎上的多次加载
+
+    // 区域推理配置
+    int m_regionInputSize;
+    std::string m_regionModelPath;
 
-    // 模型信息
-    std::vector<int64_t> m_inputShape;
-    std::vector<int64_t> m_outputShape;
-    size_t m_inputSize;
-    size_t m_outputSize;
-    bool m_modelLoaded;
+    // 状态分类器配置，其结果按 m_classRoles 对应到检测类别
+    std::string m_eyeModelPath;
+    std::string m_mouthModelPath;
+    static constexpr int CLASSIFIER_INPUT_SIZE = 64;    // 分类器输入宽高为动态维度时的取值
 
     // 检测参数
     float m_confThreshold;
     float m_nmsThreshold;
-    int m_inputWidth;
-    int m_inputHeight;
+    int m_nmsTopK;          // NMS 前按分数保留的候选数上限
 
     // 类别信息
     std::vector<std::string> m_classNames;
+    ClassRoles m_classRoles;
+
+    // 预处理：letterbox 直接写入模型槽的输入缓冲
+    Preprocessor m_preprocessor;
+    LetterboxInfo m_letterbox;
+
+    // 批量推理缓冲，按出现过的最大 batch 增长后复用
+    std::vector<float> m_batchInputBuffer;
+    std::vector<float> m_batchOutputBuffer;
+    std::vector<LetterboxInfo> m_batchLetterbox;   // 各帧的映射参数，后处理逆映射用
+
+    // 解码候选框与 NMS 缓冲，逐帧复用
+    std::vector<DecodedBox> m_candidates;
+    std::vector<int> m_keep;
+    NonMaxSuppression m_nms;
 
     // 内部处理函数
-    cv::Mat preprocess(const cv::Mat& image);
-    std::vector<Detection> postprocess(const std::vector<float>& output,
+    std::shared_ptr<ModelSlot> currentSlot() const { return std::atomic_load(&m_slot); }
+    bool bindSlot(ModelSlot& slot);
+    void bindRegion(ModelSlot& slot);
+    void bindClassifiers(ModelSlot& slot);
+    std::unique_ptr<SecondaryBinding> loadSecondary(const std::string& modelPath, int defaultSize);
+    void bindSecondary(SecondaryBinding& binding, Ort::Session& session,
+                       std::vector<int64_t> shape, int defaultSize);
+    // 在 region 裁剪上运行分类器，返回正类概率
+    float runClassifier(SecondaryBinding& binding, const cv::Mat& image, const cv::Rect& region);
+    void warmUp(ModelSlot& slot);
+    std::vector<Detection> postprocess(const float* output,
+                                       const std::vector<int64_t>& outputShape,
+                                       const LetterboxInfo& letterbox,
                                        const cv::Size& originalSize);
-    std::vector<Detection> postprocessCustomFormat(const std::vector<float>& output,
-                                                   const cv::Size& originalSize);
-    std::vector<Detection> nms(std::vector<Detection>& detections);
     void initClassNames();
-    void letterbox(const cv::Mat& src, cv::Mat& dst, const cv::Size& targetSize);
 };
 
 #endif // DETECTIONENGINE_H
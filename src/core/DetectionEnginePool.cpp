@@ -0,0 +1,195 @@
+#include "DetectionEnginePool.h"
+#include <QDebug>
+#include <algorithm>
+
+DetectionEnginePool::Lease::Lease(DetectionEnginePool* pool, DetectionEngine* engine)
+    : m_pool(pool)
+    , m_engine(engine)
+{
+}
+
+DetectionEnginePool::Lease::Lease(Lease&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_engine(other.m_engine)
+{
+    other.m_pool = nullptr;
+    other.m_engine = nullptr;
+}
+
+DetectionEnginePool::Lease& DetectionEnginePool::Lease::operator=(Lease&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_engine = other.m_engine;
+        other.m_pool = nullptr;
+        other.m_engine = nullptr;
+    }
+    return *this;
+}
+
+DetectionEnginePool::Lease::~Lease()
+{
+    release();
+}
+
+void DetectionEnginePool::Lease::release()
+{
+    if (m_pool && m_engine) {
+        m_pool->giveBack(m_engine);
+    }
+    m_pool = nullptr;
+    m_engine = nullptr;
+}
+
+DetectionEnginePool::DetectionEnginePool(std::shared_ptr<EngineFactory> factory, int poolSize)
+    : m_factory(std::move(factory))
+    , m_modelLoaded(false)
+{
+    poolSize = std::max(1, poolSize);
+    for (int i = 0; i < poolSize; ++i) {
+        m_engines.push_back(m_factory->createEngine());
+        m_idle.push_back(m_engines.back().get());
+    }
+
+    qDebug() << "Engine pool:" << poolSize << "sessions,"
+             << m_factory->options().intraOpThreads << "intra-op threads"
+             << (m_factory->options().globalThreadPool ? "(shared)" : "per session");
+}
+
+DetectionEnginePool::~DetectionEnginePool() = default;
+
+bool DetectionEnginePool::loadModel(const std::string& modelPath)
+{
+    // 不等待引擎归还：新会话在后台创建并预热，推理照常使用旧会话
+    std::lock_guard<std::mutex> loadLock(m_loadMutex);
+
+    std::vector<std::shared_ptr<ModelSlot>> slots;
+    for (size_t i = 0; i < m_engines.size(); ++i) {
+        std::shared_ptr<ModelSlot> slot = m_engines[i]->prepareModel(modelPath);
+        if (!slot) {
+            // 任一引擎失败则全部保留旧模型
+            qDebug() << "Engine" << i << "failed to load" << QString::fromStdString(modelPath)
+                     << ", keeping current model";
+            return false;
+        }
+        // 后续会话复用共享的预打包权重和 arena，增量应明显小于第一个
+        qDebug() << "Engine" << i << "resident memory +"
+                 << slot->residentMemoryDelta / (1024.0 * 1024.0) << "MB";
+        slots.push_back(std::move(slot));
+    }
+
+    // 全部就绪后一起发布，各引擎从下一次推理起使用新模型
+    for (size_t i = 0; i < m_engines.size(); ++i) {
+        m_engines[i]->publishModel(std::move(slots[i]));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_modelLoaded = true;
+    }
+    qDebug() << "Process resident memory:"
+             << EngineFactory::residentMemoryBytes() / (1024.0 * 1024.0) << "MB";
+    return true;
+}
+
+bool DetectionEnginePool::isModelLoaded() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_modelLoaded;
+}
+
+std::vector<std::string> DetectionEnginePool::classNames() const
+{
+    return m_engines.front()->getClassNames();
+}
+
+ClassRoles DetectionEnginePool::classRoles() const
+{
+    return m_engines.front()->classRoles();
+}
+
+void DetectionEnginePool::setClassRoles(const ClassRoles& roles)
+{
+    for (auto& engine : m_engines) {
+        engine->setClassRoles(roles);
+    }
+}
+
+cv::Size DetectionEnginePool::inputSize() const
+{
+    return m_engines.front()->getInputSize();
+}
+
+bool DetectionEnginePool::supportsRegionInput() const
+{
+    return m_engines.front()->supportsRegionInput();
+}
+
+void DetectionEnginePool::setRegionInput(int inputSize, const std::string& modelPath)
+{
+    for (auto& engine : m_engines) {
+        engine->setRegionInput(inputSize, modelPath);
+    }
+}
+
+bool DetectionEnginePool::supportsStateClassifier() const
+{
+    return m_engines.front()->supportsStateClassifier();
+}
+
+void DetectionEnginePool::setStateClassifiers(const std::string& eyeModelPath,
+                                              const std::string& mouthModelPath)
+{
+    for (auto& engine : m_engines) {
+        engine->setStateClassifiers(eyeModelPath, mouthModelPath);
+    }
+}
+
+DetectionEnginePool::Lease DetectionEnginePool::acquire()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleChanged.wait(lock, [this]() { return !m_idle.empty(); });
+
+    DetectionEngine* engine = m_idle.back();
+    m_idle.pop_back();
+    return Lease(this, engine);
+}
+
+DetectionEnginePool::Lease DetectionEnginePool::tryAcquire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_idle.empty()) {
+        return Lease();
+    }
+
+    DetectionEngine* engine = m_idle.back();
+    m_idle.pop_back();
+    return Lease(this, engine);
+}
+
+void DetectionEnginePool::giveBack(DetectionEngine* engine)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_idle.push_back(engine);
+    }
+    m_idleChanged.notify_all();
+}
+
+void DetectionEnginePool::setConfidenceThreshold(float threshold)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleChanged.wait(lock, [this]() { return m_idle.size() == m_engines.size(); });
+    for (auto& engine : m_engines) {
+        engine->setConfidenceThreshold(threshold);
+    }
+}
+
+void DetectionEnginePool::setNMSThreshold(float threshold)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleChanged.wait(lock, [this]() { return m_idle.size() == m_engines.size(); });
+    for (auto& engine : m_engines) {
+        engine->setNMSThreshold(threshold);
+    }
+}
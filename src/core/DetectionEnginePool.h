@@ -0,0 +1,87 @@
+#ifndef DETECTIONENGINEPOOL_H
+#define DETECTIONENGINEPOOL_H
+
+#include "DetectionEngine.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 检测引擎池：N 个会话由同一 EngineFactory 创建，共享 Env/线程池/分配器，各自持有预分配的输入输出缓冲
+// 调用方租用引擎完成一次检测后归还，同一引擎不会被两个线程同时使用
+class DetectionEnginePool
+{
+public:
+    // 租约：析构时自动归还引擎，只能移动不能复制
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        DetectionEngine* get() const { return m_engine; }
+        DetectionEngine* operator->() const { return m_engine; }
+        DetectionEngine& operator*() const { return *m_engine; }
+        explicit operator bool() const { return m_engine != nullptr; }
+
+        void release();
+
+    private:
+        friend class DetectionEnginePool;
+        Lease(DetectionEnginePool* pool, DetectionEngine* engine);
+
+        DetectionEnginePool* m_pool = nullptr;
+        DetectionEngine* m_engine = nullptr;
+    };
+
+    DetectionEnginePool(std::shared_ptr<EngineFactory> factory, int poolSize = 2);
+    ~DetectionEnginePool();
+
+    // 所有引擎加载同一模型：新会话全部预热成功后一起发布，加载期间推理不中断；
+    // 任一引擎失败时保留旧模型
+    bool loadModel(const std::string& modelPath);
+    bool isModelLoaded() const;
+    // 各引擎类别表相同，返回第一个引擎的
+    std::vector<std::string> classNames() const;
+    ClassRoles classRoles() const;
+    // 设置所有引擎的类别含义，须在开始处理前调用
+    void setClassRoles(const ClassRoles& roles);
+    // 模型输入尺寸（宽 × 高），未加载模型时为默认值
+    cv::Size inputSize() const;
+    // 模型是否支持较小的区域输入（动态宽高或单独的小输入模型）
+    bool supportsRegionInput() const;
+    // 区域推理配置，下次加载模型时生效
+    void setRegionInput(int inputSize, const std::string& modelPath);
+    // 级联第二级的眼部/嘴部状态分类器，下次加载模型时生效
+    bool supportsStateClassifier() const;
+    void setStateClassifiers(const std::string& eyeModelPath, const std::string& mouthModelPath);
+
+    // acquire 阻塞直到有空闲引擎；tryAcquire 无空闲时返回空租约
+    Lease acquire();
+    Lease tryAcquire();
+
+    int size() const { return static_cast<int>(m_engines.size()); }
+    std::shared_ptr<EngineFactory> factory() const { return m_factory; }
+
+    void setConfidenceThreshold(float threshold);
+    void setNMSThreshold(float threshold);
+
+private:
+    void giveBack(DetectionEngine* engine);
+
+    std::shared_ptr<EngineFactory> m_factory;
+    std::vector<std::unique_ptr<DetectionEngine>> m_engines;
+    std::vector<DetectionEngine*> m_idle;
+    bool m_modelLoaded;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_idleChanged;
+    std::mutex m_loadMutex;     // 串行化模型加载，不阻塞租用
+};
+
+#endif // DETECTIONENGINEPOOL_H
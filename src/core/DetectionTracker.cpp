@@ -0,0 +1,314 @@
+#include "DetectionTracker.h"
+#include <algorithm>
+
+namespace {
+
+// 名义帧长：速度和过程噪声按 30fps 的一帧计
+constexpr double kNominalFrameNs = 1e9 / 30.0;
+
+// 噪声与框高成比例（DeepSORT 的取值），远近不同的人脸使用同一组参数
+constexpr float kPositionWeight = 1.0f / 20.0f;
+constexpr float kVelocityWeight = 1.0f / 160.0f;
+
+// 置信度平滑系数：新检测所占的比重
+constexpr float kScoreAlpha = 0.5f;
+
+float iou(const cv::Rect2f& a, const cv::Rect2f& b)
+{
+    const float intersection = (a & b).area();
+    const float unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0.0f ? intersection / unionArea : 0.0f;
+}
+
+cv::Rect2f detectionBox(const FrameDetection& detection)
+{
+    return cv::Rect2f(detection.x, detection.y, detection.width, detection.height);
+}
+
+} // namespace
+
+cv::Rect2f Track::box() const
+{
+    const float width = std::max(1.0f, state(2));
+    const float height = std::max(1.0f, state(3));
+    return cv::Rect2f(state(0) - width / 2.0f, state(1) - height / 2.0f, width, height);
+}
+
+DetectionTracker::DetectionTracker(const TrackerOptions& options)
+    : m_options(options)
+    , m_nextId(1)
+    , m_framesSinceDetection(0)
+    , m_trackLost(false)
+    , m_predicted(0)
+    , m_activeTracks(0)
+{
+}
+
+void DetectionTracker::setOptions(const TrackerOptions& options)
+{
+    m_options = options;
+}
+
+void DetectionTracker::reset()
+{
+    m_tracks.clear();
+    m_nextId = 1;
+    m_framesSinceDetection = 0;
+    m_trackLost = false;
+    m_frameSize = cv::Size();
+    m_predicted.store(0, std::memory_order_relaxed);
+    m_activeTracks.store(0, std::memory_order_relaxed);
+}
+
+bool DetectionTracker::detectionDue(const cv::Size& frameSize, bool cascade) const
+{
+    const int interval = cascade ? std::max(m_options.detectInterval, m_options.cascadeDetectInterval)
+                                 : m_options.detectInterval;
+    return frameSize != m_frameSize || m_tracks.empty() || m_trackLost
+           || m_framesSinceDetection + 1 >= interval;
+}
+
+void DetectionTracker::update(FrameResult& result, int64_t timestampNs)
+{
+    const cv::Size frameSize(result.imageWidth, result.imageHeight);
+    if (frameSize != m_frameSize) {
+        // 分辨率变化后旧轨迹的坐标不再有效
+        m_tracks.clear();
+        m_frameSize = frameSize;
+    }
+    predictTo(timestampNs);
+
+    // 按 IoU 贪心关联，同类别的配对优先
+    m_candidates.clear();
+    for (int t = 0; t < static_cast<int>(m_tracks.size()); ++t) {
+        const cv::Rect2f predicted = m_tracks[t].box();
+        for (int d = 0; d < result.count; ++d) {
+            const float overlap = iou(predicted, detectionBox(result.detections[d]));
+            if (overlap >= m_options.iouThreshold) {
+                const bool sameClass = m_tracks[t].classId == result.detections[d].classId;
+                m_candidates.push_back({overlap + (sameClass ? 1.0f : 0.0f), t, d});
+            }
+        }
+    }
+    std::sort(m_candidates.begin(), m_candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+
+    m_trackMatched.assign(m_tracks.size(), 0);
+    m_detectionMatched.assign(result.count, 0);
+    for (const Candidate& candidate : m_candidates) {
+        if (m_trackMatched[candidate.track] || m_detectionMatched[candidate.detection]) {
+            continue;
+        }
+        m_trackMatched[candidate.track] = 1;
+        m_detectionMatched[candidate.detection] = 1;
+
+        Track& track = m_tracks[candidate.track];
+        const FrameDetection& detection = result.detections[candidate.detection];
+        correct(track, detection);
+        track.classId = detection.classId;
+        track.score = kScoreAlpha * detection.score + (1.0f - kScoreAlpha) * track.score;
+        ++track.hits;
+        track.misses = 0;
+    }
+
+    // 未匹配的轨迹：未确认的立即删除，确认的容忍 maxMisses 次
+    m_trackLost = false;
+    size_t kept = 0;
+    for (size_t t = 0; t < m_tracks.size(); ++t) {
+        Track& track = m_tracks[t];
+        if (!m_trackMatched[t]) {
+            ++track.misses;
+            m_trackLost = true;
+            const int allowed = track.confirmed(m_options.minHits) ? m_options.maxMisses : 0;
+            if (track.misses > allowed) {
+                continue;
+            }
+        }
+        if (kept != t) {
+            m_tracks[kept] = track;
+        }
+        ++kept;
+    }
+    m_tracks.resize(kept);
+
+    // 未匹配的检测开始新轨迹
+    for (int d = 0; d < result.count; ++d) {
+        if (!m_detectionMatched[d]) {
+            m_tracks.push_back(createTrack(result.detections[d], timestampNs));
+        }
+    }
+
+    m_framesSinceDetection = 0;
+    m_activeTracks.store(static_cast<int>(m_tracks.size()), std::memory_order_relaxed);
+    fill(result);
+}
+
+void DetectionTracker::predict(FrameResult& result, int64_t timestampNs)
+{
+    predictTo(timestampNs);
+    ++m_framesSinceDetection;
+    m_predicted.fetch_add(1, std::memory_order_relaxed);
+
+    // 确认的轨迹中心预测到画面外时视为丢失，下一帧推理
+    const cv::Rect2f frame(0.0f, 0.0f, static_cast<float>(m_frameSize.width),
+                           static_cast<float>(m_frameSize.height));
+    for (const Track& track : m_tracks) {
+        const cv::Point2f center(track.state(0), track.state(1));
+        if (track.confirmed(m_options.minHits) && !frame.contains(center)) {
+            m_trackLost = true;
+        }
+    }
+    fill(result);
+}
+
+bool DetectionTracker::lockedRegion(cv::Rect& region) const
+{
+    if (m_tracks.empty() || m_trackLost) {
+        return false;
+    }
+
+    cv::Rect2f bounds;
+    for (const Track& track : m_tracks) {
+        if (!track.confirmed(m_options.minHits) || track.misses > 0) {
+            return false;
+        }
+        // 框按当前状态外扩，覆盖到下次推理前的移动
+        const cv::Rect2f box = track.box();
+        const float padX = box.width * m_options.regionPadding;
+        const float padY = box.height * m_options.regionPadding;
+        const cv::Rect2f padded(box.x - padX, box.y - padY,
+                                box.width + 2.0f * padX, box.height + 2.0f * padY);
+        bounds = bounds.area() > 0.0f ? (bounds | padded) : padded;
+    }
+
+    const cv::Rect frame(0, 0, m_frameSize.width, m_frameSize.height);
+    region = cv::Rect(cv::Point(cvFloor(bounds.x), cvFloor(bounds.y)),
+                      cv::Point(cvCeil(bounds.br().x), cvCeil(bounds.br().y))) & frame;
+    return region.area() > 0;
+}
+
+void DetectionTracker::reclassify(int trackId, int classId, float score)
+{
+    for (Track& track : m_tracks) {
+        if (track.id == trackId) {
+            track.classId = classId;
+            track.score = kScoreAlpha * score + (1.0f - kScoreAlpha) * track.score;
+            return;
+        }
+    }
+}
+
+void DetectionTracker::predictTo(int64_t timestampNs)
+{
+    for (Track& track : m_tracks) {
+        const float dt = static_cast<float>((timestampNs - track.lastNs) / kNominalFrameNs);
+        if (dt <= 0.0f) {
+            continue;
+        }
+
+        cv::Matx<float, 8, 8> transition = cv::Matx<float, 8, 8>::eye();
+        for (int i = 0; i < 4; ++i) {
+            transition(i, i + 4) = dt;
+        }
+
+        const float height = std::max(1.0f, track.state(3));
+        const float positionStd = kPositionWeight * height;
+        const float velocityStd = kVelocityWeight * height;
+        cv::Matx<float, 8, 8> noise = cv::Matx<float, 8, 8>::zeros();
+        for (int i = 0; i < 4; ++i) {
+            noise(i, i) = positionStd * positionStd * dt;
+            noise(i + 4, i + 4) = velocityStd * velocityStd * dt;
+        }
+
+        track.state = transition * track.state;
+        track.covariance = transition * track.covariance * transition.t() + noise;
+        track.lastNs = timestampNs;
+    }
+}
+
+void DetectionTracker::correct(Track& track, const FrameDetection& detection)
+{
+    // 观测为 [cx, cy, w, h]，即状态的前 4 维
+    const cv::Vec4f measurement(detection.x + detection.width / 2.0f,
+                                detection.y + detection.height / 2.0f,
+                                detection.width, detection.height);
+    const float measurementStd = kPositionWeight * std::max(1.0f, detection.height);
+
+    cv::Matx<float, 4, 4> innovation = track.covariance.get_minor<4, 4>(0, 0);
+    for (int i = 0; i < 4; ++i) {
+        innovation(i, i) += measurementStd * measurementStd;
+    }
+    const cv::Matx<float, 8, 4> gain = track.covariance.get_minor<8, 4>(0, 0) * innovation.inv();
+
+    cv::Matx<float, 4, 1> residual;
+    for (int i = 0; i < 4; ++i) {
+        residual(i) = measurement[i] - track.state(i);
+    }
+    track.state += gain * residual;
+    track.covariance -= gain * track.covariance.get_minor<4, 8>(0, 0);
+}
+
+Track DetectionTracker::createTrack(const FrameDetection& detection, int64_t timestampNs)
+{
+    Track track;
+    track.id = m_nextId++;
+    track.classId = detection.classId;
+    track.score = detection.score;
+    track.hits = 1;
+    track.lastNs = timestampNs;
+
+    track.state = cv::Matx<float, 8, 1>::zeros();
+    track.state(0) = detection.x + detection.width / 2.0f;
+    track.state(1) = detection.y + detection.height / 2.0f;
+    track.state(2) = detection.width;
+    track.state(3) = detection.height;
+
+    const float height = std::max(1.0f, detection.height);
+    const float positionStd = 2.0f * kPositionWeight * height;
+    const float velocityStd = 10.0f * kVelocityWeight * height;
+    track.covariance = cv::Matx<float, 8, 8>::zeros();
+    for (int i = 0; i < 4; ++i) {
+        track.covariance(i, i) = positionStd * positionStd;
+        track.covariance(i + 4, i + 4) = velocityStd * velocityStd;
+    }
+    return track;
+}
+
+void DetectionTracker::fill(FrameResult& result) const
+{
+    // 丢失中的轨迹继续输出预测框，直到被删除；按置信度降序，超出容量的截断
+    const cv::Rect2f frame(0.0f, 0.0f, static_cast<float>(m_frameSize.width),
+                           static_cast<float>(m_frameSize.height));
+    result.count = 0;
+    for (const Track& track : m_tracks) {
+        const cv::Rect2f box = track.box() & frame;
+        if (box.area() <= 0.0f) {
+            continue;
+        }
+
+        int slot = result.count;
+        if (slot == FrameResult::MAX_DETECTIONS) {
+            if (result.detections[slot - 1].score >= track.score) {
+                continue;
+            }
+            --slot;
+        } else {
+            ++result.count;
+        }
+        while (slot > 0 && result.detections[slot - 1].score < track.score) {
+            result.detections[slot] = result.detections[slot - 1];
+            --slot;
+        }
+
+        FrameDetection& out = result.detections[slot];
+        out.x = box.x;
+        out.y = box.y;
+        out.width = box.width;
+        out.height = box.height;
+        out.score = track.score;
+        out.classId = track.classId;
+        out.trackId = track.id;
+        out.trackHits = track.hits;
+        out.trackMisses = track.misses;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef DETECTIONTRACKER_H
+#define DETECTIONTRACKER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "FrameResult.h"
+
+// 跟踪器配置
+struct TrackerOptions {
+    int detectInterval = 2;         // 每隔多少帧推理一次，1 表示每帧推理
+    float iouThreshold = 0.3f;      // 检测与预测框的最小 IoU
+    int minHits = 2;                // 累计匹配到这么多次才算确认的轨迹
+    int maxMisses = 3;              // 确认的轨迹连续这么多次推理未匹配到即删除
+    bool regionInference = true;    // 轨迹稳定时只在人脸区域内推理（需模型支持较小输入）
+    float regionPadding = 0.5f;     // 区域在轨迹框外扩的比例（按框宽高计）
+    int reacquireInterval = 10;     // 连续区域推理这么多次后做一次整帧推理，发现新目标
+    int cascadeDetectInterval = 10; // 有状态分类器时的推理间隔，两次检测之间由分类器逐帧判断状态
+};
+
+// 单条轨迹：恒速模型的卡尔曼滤波，状态为 [cx, cy, w, h, vx, vy, vw, vh]。
+// 时间以 30fps 的名义帧为单位，跳过推理的帧按实际时间间隔预测
+struct Track {
+    int id = 0;
+    int classId = -1;               // 最近一次匹配到的检测类别（闭眼/哈欠等状态会随之切换）
+    float score = 0.0f;             // 置信度的指数平滑
+    int hits = 0;                   // 累计匹配次数，未匹配时不清零
+    int misses = 0;                 // 连续未匹配的推理次数
+    int64_t lastNs = 0;             // 状态对应的时刻
+
+    cv::Matx<float, 8, 1> state;
+    cv::Matx<float, 8, 8> covariance;
+
+    bool confirmed(int minHits) const { return hits >= minHits; }
+    cv::Rect2f box() const;
+};
+
+// 检测跟踪：按 IoU 把每次推理的检测关联到已有轨迹并分配持久的轨迹 ID，
+// 两次推理之间用卡尔曼预测给出平滑的框。只在推理线程中使用
+class DetectionTracker
+{
+public:
+    explicit DetectionTracker(const TrackerOptions& options = TrackerOptions());
+
+    void setOptions(const TrackerOptions& options);
+    const TrackerOptions& options() const { return m_options; }
+    // 清空所有轨迹，下一帧必定推理
+    void reset();
+
+    // 本帧是否需要推理：到了推理间隔、没有轨迹、上次推理有轨迹丢失，或帧尺寸变化。
+    // cascade 为 true 时按 cascadeDetectInterval 计算间隔
+    bool detectionDue(const cv::Size& frameSize, bool cascade = false) const;
+
+    // 推理帧：result 中的检测更新轨迹，随后 result 改写为轨迹的平滑框、轨迹 ID 和命中数
+    void update(FrameResult& result, int64_t timestampNs);
+    // 非推理帧：轨迹预测到 timestampNs，写入 result
+    void predict(FrameResult& result, int64_t timestampNs);
+    // 状态分类器给出的类别写回轨迹，后续预测帧和关联沿用
+    void reclassify(int trackId, int classId, float score);
+
+    // 所有轨迹均已确认且上次推理都匹配到时，返回它们外扩 regionPadding 后的并集（裁剪到帧内）；
+    // 否则返回 false，应做整帧推理
+    bool lockedRegion(cv::Rect& region) const;
+
+    const std::vector<Track>& tracks() const { return m_tracks; }
+
+    uint64_t predictedFrames() const { return m_predicted.load(std::memory_order_relaxed); }
+    int activeTracks() const { return m_activeTracks.load(std::memory_order_relaxed); }
+
+private:
+    void predictTo(int64_t timestampNs);
+    void fill(FrameResult& result) const;
+    Track createTrack(const FrameDetection& detection, int64_t timestampNs);
+    void correct(Track& track, const FrameDetection& detection);
+
+    TrackerOptions m_options;
+    std::vector<Track> m_tracks;
+    int m_nextId;
+    int m_framesSinceDetection;
+    bool m_trackLost;
+    cv::Size m_frameSize;
+
+    // 关联用的缓冲，逐帧复用
+    struct Candidate {
+        float score;
+        int track;
+        int detection;
+    };
+    std::vector<Candidate> m_candidates;
+    std::vector<char> m_trackMatched;
+    std::vector<char> m_detectionMatched;
+
+    std::atomic<uint64_t> m_predicted;
+    std::atomic<int> m_activeTracks;
+};
+
+#endif // DETECTIONTRACKER_H
@@ -0,0 +1,297 @@
+#include "EngineFactory.h"
+#include "DetectionEngine.h"
+#include "ThreadPlacement.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QString>
+#include <QSysInfo>
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 会话使用的图优化级别；缓存 key 也由它决定
+constexpr GraphOptimizationLevel kOptimizationLevel = GraphOptimizationLevel::ORT_ENABLE_EXTENDED;
+
+// ORT 自定义线程创建：线程启动后先应用放置策略，再进入 ORT 的工作函数
+OrtCustomThreadHandle createPlacedThread(void* /*options*/, OrtThreadWorkerFn work, void* param)
+{
+    auto* thread = new std::thread([work, param]() {
+        ThreadPlacement::apply(ThreadRole::IntraOp);
+        work(param);
+    });
+    return reinterpret_cast<OrtCustomThreadHandle>(thread);
+}
+
+void joinPlacedThread(OrtCustomThreadHandle handle)
+{
+    auto* thread = reinterpret_cast<std::thread*>(const_cast<OrtCustomHandleType*>(handle));
+    thread->join();
+    delete thread;
+}
+
+// 本机 CPU 的标识：架构、厂商、型号和指令集扩展。ORT 按这些选择优化后的内核和布局，
+// 换机器或换 CPU 后缓存的图不能直接使用
+QByteArray cpuSignature()
+{
+    static const QByteArray signature = []() {
+        QByteArray result = QSysInfo::currentCpuArchitecture().toLatin1();
+#ifdef _WIN32
+        int info[4] = {0, 0, 0, 0};
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        result += ';';
+        result += QByteArray(reinterpret_cast<const char*>(&info[1]), 4);
+        result += QByteArray(reinterpret_cast<const char*>(&info[3]), 4);
+        result += QByteArray(reinterpret_cast<const char*>(&info[2]), 4);
+        __cpuid(info, 1);
+        result += ";family=" + QByteArray::number(info[0]);
+        result += ";ecx=" + QByteArray::number(info[2]) + ";edx=" + QByteArray::number(info[3]);
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            result += ";ebx7=" + QByteArray::number(info[1]) + ";ecx7=" + QByteArray::number(info[2]);
+        }
+#else
+        // 取第一个处理器的描述即可，同一台机器上各核相同
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line) && !line.empty()) {
+            const size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            QByteArray key = QByteArray::fromStdString(line.substr(0, colon)).trimmed();
+            if (key == "vendor_id" || key == "model name" || key == "flags"
+                || key == "CPU implementer" || key == "CPU part" || key == "Features") {
+                result += ';' + key + '=' + QByteArray::fromStdString(line.substr(colon + 1)).trimmed();
+            }
+        }
+#endif
+        return result;
+    }();
+    return signature;
+}
+
+} // namespace
+
+EngineFactory::EngineFactory(const EngineFactoryOptions& options)
+    : m_options(options)
+    , m_sharedAllocator(false)
+{
+    m_options.intraOpThreads = std::max(1, m_options.intraOpThreads);
+
+    if (m_options.globalThreadPool) {
+        Ort::ThreadingOptions threading;
+        threading.SetGlobalIntraOpNumThreads(m_options.intraOpThreads);
+        threading.SetGlobalInterOpNumThreads(1);
+        if (m_options.placeIntraOpThreads) {
+            threading.SetGlobalCustomCreateThreadFn(createPlacedThread);
+            threading.SetGlobalCustomJoinThreadFn(joinPlacedThread);
+        }
+        m_env = std::make_unique<Ort::Env>(threading, ORT_LOGGING_LEVEL_WARNING, "EngineFactory");
+    } else {
+        m_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "EngineFactory");
+    }
+
+    // 注册共享 CPU arena，会话通过 session.use_env_allocators 使用
+    try {
+        const int extendStrategy = (m_options.arenaExtendStrategy == "next_power_of_two") ? 0 : 1;
+        const size_t memoryLimit = static_cast<size_t>(std::max(0, m_options.arenaMemoryLimitMB)) << 20;
+        Ort::ArenaCfg arenaCfg(memoryLimit, extendStrategy, -1, -1);
+        Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        m_env->CreateAndRegisterAllocator(memoryInfo, arenaCfg);
+        m_sharedAllocator = true;
+    } catch (const Ort::Exception& e) {
+        qDebug() << "Shared allocator unavailable, sessions use their own arena:" << e.what();
+    }
+
+    m_prepackedWeights = std::make_unique<Ort::PrepackedWeightsContainer>();
+
+    qDebug() << "EngineFactory:"
+             << (m_options.globalThreadPool ? "global" : "per-session")
+             << "thread pool," << m_options.intraOpThreads << "intra-op threads,"
+             << "arena" << QString::fromStdString(m_options.arenaExtendStrategy)
+             << "limit" << m_options.arenaMemoryLimitMB << "MB";
+}
+
+EngineFactory::~EngineFactory() = default;
+
+std::unique_ptr<DetectionEngine> EngineFactory::createEngine()
+{
+    return std::make_unique<DetectionEngine>(shared_from_this());
+}
+
+Ort::SessionOptions EngineFactory::createSessionOptions() const
+{
+    Ort::SessionOptions options;
+    if (m_options.globalThreadPool) {
+        options.DisablePerSessionThreads();
+    } else {
+        options.SetIntraOpNumThreads(m_options.intraOpThreads);
+        if (m_options.placeIntraOpThreads) {
+            options.SetCustomCreateThreadFn(createPlacedThread);
+            options.SetCustomJoinThreadFn(joinPlacedThread);
+        }
+    }
+    options.SetGraphOptimizationLevel(kOptimizationLevel);
+
+    if (m_sharedAllocator) {
+        options.AddConfigEntry("session.use_env_allocators", "1");
+    }
+    return options;
+}
+
+std::unique_ptr<Ort::Session> EngineFactory::createSession(const std::string& modelPath)
+{
+    Ort::SessionOptions options = createSessionOptions();
+    if (!m_options.cacheOptimizedModel) {
+        return openSession(modelPath, options);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const std::string cachePath = optimizedModelPath(modelPath);
+    const double keyMs = timer.nsecsElapsed() / 1e6;
+
+    // 命中缓存：加载已优化的图，关闭图优化
+    if (!cachePath.empty() && QFile::exists(QString::fromStdString(cachePath))) {
+        try {
+            timer.restart();
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            auto session = openSession(cachePath, options);
+            qDebug() << "Session from optimized cache: key" << keyMs << "ms, create"
+                     << timer.nsecsElapsed() / 1e6 << "ms";
+            return session;
+        } catch (const Ort::Exception& e) {
+            // 缓存损坏（如写入时断电），删除后重新生成
+            qDebug() << "Optimized model cache unusable, rebuilding:" << e.what();
+            QFile::remove(QString::fromStdString(cachePath));
+            options = createSessionOptions();
+        }
+    }
+
+    // 未命中：正常优化并把结果写入临时文件，会话创建成功后再改名，避免留下半个文件
+    timer.restart();
+    const QString tempPath = QString::fromStdString(cachePath) + ".tmp";
+    if (!cachePath.empty()) {
+#ifdef _WIN32
+        options.SetOptimizedModelFilePath(tempPath.toStdWString().c_str());
+#else
+        options.SetOptimizedModelFilePath(tempPath.toStdString().c_str());
+#endif
+    }
+    std::unique_ptr<Ort::Session> session;
+    try {
+        session = openSession(modelPath, options);
+    } catch (const Ort::Exception& e) {
+        if (cachePath.empty()) {
+            throw;
+        }
+        // 缓存写不进去（目录只读、磁盘满）不应影响模型加载，不带缓存重试
+        qDebug() << "Failed to write optimized model cache, loading without it:" << e.what();
+        QFile::remove(tempPath);
+        options = createSessionOptions();
+        session = openSession(modelPath, options);
+        qDebug() << "Session without cache: create" << timer.nsecsElapsed() / 1e6 << "ms";
+        return session;
+    }
+    const double createMs = timer.nsecsElapsed() / 1e6;
+
+    if (!cachePath.empty()) {
+        QFile::remove(QString::fromStdString(cachePath));
+        if (!QFile::rename(tempPath, QString::fromStdString(cachePath))) {
+            QFile::remove(tempPath);
+        }
+    }
+    qDebug() << "Session with graph optimization: key" << keyMs << "ms, create + serialize"
+             << createMs << "ms";
+    return session;
+}
+
+std::unique_ptr<Ort::Session> EngineFactory::openSession(const std::string& path,
+                                                         Ort::SessionOptions& options)
+{
+#ifdef _WIN32
+    std::wstring ortPath = QString::fromStdString(path).toStdWString();
+#else
+    const std::string& ortPath = path;
+#endif
+    return std::make_unique<Ort::Session>(*m_env, ortPath.c_str(), options, *m_prepackedWeights);
+}
+
+std::string EngineFactory::optimizedModelPath(const std::string& modelPath)
+{
+    const QFileInfo info(QString::fromStdString(modelPath));
+    const qint64 size = info.size();
+    const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+
+    // 池中各引擎加载同一模型时只有第一个计算哈希；文件被替换后重新计算
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    CacheEntry& entry = m_cachePaths[modelPath];
+    if (entry.size == size && entry.modifiedMs == modifiedMs) {
+        return entry.cachePath;
+    }
+
+    QFile file(info.filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_cachePaths.erase(modelPath);
+        return std::string();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(&file);
+    hash.addData(QByteArray("ort=") + OrtGetApiBase()->GetVersionString());
+    hash.addData(cpuSignature());
+    // 影响优化结果的会话配置：执行提供程序和图优化级别
+    hash.addData(QByteArray("cpu;level=") + QByteArray::number(static_cast<int>(kOptimizationLevel)));
+
+    // 模型目录只读（安装目录）时放到用户缓存目录
+    QString directory = info.path();
+    if (!QFileInfo(directory).isWritable()) {
+        directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/models";
+        if (!QDir().mkpath(directory)) {
+            m_cachePaths.erase(modelPath);
+            return std::string();
+        }
+    }
+
+    const QString key = QString::fromLatin1(hash.result().toHex().left(16));
+    entry.size = size;
+    entry.modifiedMs = modifiedMs;
+    entry.cachePath = (directory + "/" + info.completeBaseName() + "." + key + ".opt.onnx").toStdString();
+    return entry.cachePath;
+}
+
+size_t EngineFactory::residentMemoryBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+#endif
+}
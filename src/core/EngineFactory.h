@@ -0,0 +1,63 @@
+#ifndef ENGINEFACTORY_H
+#define ENGINEFACTORY_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <onnxruntime_cxx_api.h>
+
+class DetectionEngine;
+
+// ONNX Runtime 资源配置
+struct EngineFactoryOptions {
+    bool globalThreadPool = true;       // 所有会话共用 Env 的全局线程池
+    int intraOpThreads = 4;             // 全局线程池大小，或未启用时每个会话的线程数
+    std::string arenaExtendStrategy = "same_as_requested";  // 或 "next_power_of_two"
+    int arenaMemoryLimitMB = 0;         // 共享 CPU arena 上限，0 表示不限制
+    bool cacheOptimizedModel = true;    // 在模型旁缓存优化后的图，后续加载跳过图优化
+    bool placeIntraOpThreads = false;   // 由本程序创建 ORT 算子线程，按 ThreadRole::IntraOp 放置
+};
+
+// 引擎工厂：持有唯一的 Ort::Env、全局线程池、共享 CPU arena 和预打包权重容器
+// 由它创建的所有会话共享上述资源，避免每个引擎重复占用内存
+class EngineFactory : public std::enable_shared_from_this<EngineFactory>
+{
+public:
+    explicit EngineFactory(const EngineFactoryOptions& options = EngineFactoryOptions());
+    ~EngineFactory();
+
+    std::unique_ptr<DetectionEngine> createEngine();
+
+    // 按统一配置创建会话
+    std::unique_ptr<Ort::Session> createSession(const std::string& modelPath);
+
+    const EngineFactoryOptions& options() const { return m_options; }
+
+    // 当前进程常驻内存（字节），用于统计每个引擎的内存占用
+    static size_t residentMemoryBytes();
+
+private:
+    EngineFactoryOptions m_options;
+    std::unique_ptr<Ort::Env> m_env;
+    std::unique_ptr<Ort::PrepackedWeightsContainer> m_prepackedWeights;
+    bool m_sharedAllocator;
+
+    Ort::SessionOptions createSessionOptions() const;
+    std::unique_ptr<Ort::Session> openSession(const std::string& path, Ort::SessionOptions& options);
+
+    // 缓存路径：<模型名>.<key>.opt.onnx，key 由模型内容哈希、ORT 版本、CPU 型号与指令集和会话配置决定。
+    // 模型目录可写时放在模型旁，否则放在用户缓存目录；同一模型文件只哈希一次
+    std::string optimizedModelPath(const std::string& modelPath);
+
+    struct CacheEntry {
+        int64_t size = -1;
+        int64_t modifiedMs = -1;
+        std::string cachePath;
+    };
+    std::mutex m_cacheMutex;
+    std::map<std::string, CacheEntry> m_cachePaths;    // 模型路径 -> 缓存路径
+};
+
+#endif // ENGINEFACTORY_H
@@ -0,0 +1,266 @@
+#include "FatigueMonitor.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// 每个窗口的桶数：PERCLOS 窗口 60 秒时桶宽 1 秒
+constexpr int kWindowBuckets = 60;
+
+constexpr int64_t kNsPerMs = 1000000;
+
+} // namespace
+
+const char* fatigueLevelName(FatigueLevel level)
+{
+    switch (level) {
+    case FatigueLevel::Drowsy:
+        return "drowsy";
+    case FatigueLevel::Critical:
+        return "critical";
+    default:
+        return "alert";
+    }
+}
+
+void SlidingWindow::configure(int64_t windowNs, int buckets)
+{
+    m_buckets.assign(std::max(1, buckets), Bucket());
+    m_bucketNs = std::max<int64_t>(1, windowNs / static_cast<int64_t>(m_buckets.size()));
+    reset();
+}
+
+void SlidingWindow::reset()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), Bucket());
+    m_head = -1;
+    m_sum = 0;
+    m_max = 0;
+}
+
+void SlidingWindow::advance(int64_t timestampNs)
+{
+    const int64_t head = timestampNs / m_bucketNs;
+    if (m_head < 0) {
+        m_head = head;
+        return;
+    }
+    if (head <= m_head) {
+        return;
+    }
+
+    // 长时间无帧时最多清空一整圈
+    const int64_t size = static_cast<int64_t>(m_buckets.size());
+    const int64_t steps = std::min(head - m_head, size);
+    bool maxExpired = false;
+    for (int64_t i = 1; i <= steps; ++i) {
+        Bucket& bucket = m_buckets[(m_head + i) % size];
+        m_sum -= bucket.sum;
+        maxExpired = maxExpired || (bucket.max > 0 && bucket.max >= m_max);
+        bucket = Bucket();
+    }
+    m_head = head;
+
+    // 最大值所在的桶过期时才重新扫描，每个桶宽至多一次
+    if (maxExpired) {
+        m_max = 0;
+        for (const Bucket& bucket : m_buckets) {
+            m_max = std::max(m_max, bucket.max);
+        }
+    }
+}
+
+void SlidingWindow::add(int64_t value)
+{
+    if (m_head < 0) {
+        return;
+    }
+    m_buckets[m_head % static_cast<int64_t>(m_buckets.size())].sum += value;
+    m_sum += value;
+}
+
+void SlidingWindow::raiseMax(int64_t value)
+{
+    if (m_head < 0) {
+        return;
+    }
+    Bucket& bucket = m_buckets[m_head % static_cast<int64_t>(m_buckets.size())];
+    bucket.max = std::max(bucket.max, value);
+    m_max = std::max(m_max, value);
+}
+
+FatigueMonitor::FatigueMonitor(const FatigueOptions& options)
+    : m_closedClass(-1)
+    , m_yawnClass(-1)
+{
+    setOptions(options);
+}
+
+FatigueOptions FatigueMonitor::validated(const FatigueOptions& options)
+{
+    FatigueOptions o = options;
+    o.perclosWindowMs = std::max(1000, o.perclosWindowMs);
+    o.yawnWindowMs = std::max(1000, o.yawnWindowMs);
+    o.minObservationMs = std::clamp(o.minObservationMs, 0, o.perclosWindowMs);
+    o.criticalPerclos = std::clamp(o.criticalPerclos, 0.0, 1.0);
+    o.drowsyPerclos = std::clamp(o.drowsyPerclos, 0.0, o.criticalPerclos);
+    o.criticalYawns = std::max(1, o.criticalYawns);
+    o.drowsyYawns = std::clamp(o.drowsyYawns, 1, o.criticalYawns);
+    o.criticalClosureMs = std::max(1, o.criticalClosureMs);
+    o.drowsyClosureMs = std::clamp(o.drowsyClosureMs, 1, o.criticalClosureMs);
+    o.recoveryMs = std::max(0, o.recoveryMs);
+    o.yawnGapMs = std::max(0, o.yawnGapMs);
+    o.maxFrameGapMs = std::max(1, o.maxFrameGapMs);
+    o.minHits = std::max(1, o.minHits);
+
+    auto report = [](const char* name, double from, double to) {
+        if (from != to) {
+            qDebug() << "Fatigue option" << name << from << "adjusted to" << to;
+        }
+    };
+    report("perclos window ms", options.perclosWindowMs, o.perclosWindowMs);
+    report("yawn window ms", options.yawnWindowMs, o.yawnWindowMs);
+    report("min observation ms", options.minObservationMs, o.minObservationMs);
+    report("critical perclos", options.criticalPerclos, o.criticalPerclos);
+    report("drowsy perclos", options.drowsyPerclos, o.drowsyPerclos);
+    report("critical yawns", options.criticalYawns, o.criticalYawns);
+    report("drowsy yawns", options.drowsyYawns, o.drowsyYawns);
+    report("critical closure ms", options.criticalClosureMs, o.criticalClosureMs);
+    report("drowsy closure ms", options.drowsyClosureMs, o.drowsyClosureMs);
+    report("recovery ms", options.recoveryMs, o.recoveryMs);
+    report("yawn gap ms", options.yawnGapMs, o.yawnGapMs);
+    report("max frame gap ms", options.maxFrameGapMs, o.maxFrameGapMs);
+    report("min hits", options.minHits, o.minHits);
+    return o;
+}
+
+void FatigueMonitor::setOptions(const FatigueOptions& options)
+{
+    m_options = validated(options);
+    m_observed.configure(static_cast<int64_t>(m_options.perclosWindowMs) * kNsPerMs, kWindowBuckets);
+    m_closed.configure(static_cast<int64_t>(m_options.perclosWindowMs) * kNsPerMs, kWindowBuckets);
+    m_yawns.configure(static_cast<int64_t>(m_options.yawnWindowMs) * kNsPerMs, kWindowBuckets);
+    reset();
+}
+
+void FatigueMonitor::setClassRoles(const ClassRoles& roles)
+{
+    m_closedClass = roles.eyesClosed;
+    m_yawnClass = roles.yawn;
+}
+
+void FatigueMonitor::reset()
+{
+    m_observed.reset();
+    m_closed.reset();
+    m_yawns.reset();
+    m_lastFrameNs = -1;
+    m_closureStartNs = -1;
+    m_lastYawnNs = -1;
+    m_recoverSinceNs = -1;
+    m_level = FatigueLevel::Alert;
+    m_metrics = FatigueMetrics();
+    m_lastEvent = FatigueEvent();
+}
+
+bool FatigueMonitor::update(const FrameResult& result)
+{
+    const int64_t nowNs = result.captureNs;
+    m_observed.advance(nowNs);
+    m_closed.advance(nowNs);
+    m_yawns.advance(nowNs);
+
+    // 本帧代表的时长：距上一帧的间隔，过长的间隔按上限计
+    const int64_t maxGapNs = static_cast<int64_t>(m_options.maxFrameGapMs) * kNsPerMs;
+    const int64_t frameNs = m_lastFrameNs >= 0 ? std::clamp<int64_t>(nowNs - m_lastFrameNs, 0, maxGapNs)
+                                               : 0;
+    m_lastFrameNs = nowNs;
+
+    // 驾驶员：置信度最高的已确认轨迹（检测按置信度降序排列）。
+    // 该轨迹已丢失检测时类别只是丢失前的，本帧按没有看到人脸处理，也不改用其他轨迹
+    const FrameDetection* driver = nullptr;
+    for (int i = 0; i < result.count; ++i) {
+        const FrameDetection& detection = result.detections[i];
+        if (detection.trackId >= 0 && detection.trackHits >= m_options.minHits) {
+            if (detection.trackMisses == 0) {
+                driver = &detection;
+            }
+            break;
+        }
+    }
+
+    if (driver) {
+        const bool closed = driver->classId == m_closedClass;
+        const bool yawning = driver->classId == m_yawnClass;
+
+        m_observed.add(frameNs);
+        if (closed) {
+            m_closed.add(frameNs);
+            if (m_closureStartNs < 0) {
+                m_closureStartNs = nowNs;
+            }
+            m_closed.raiseMax(nowNs - m_closureStartNs);
+        } else {
+            m_closureStartNs = -1;
+        }
+
+        // 哈欠按开始计数，短暂中断（类别抖动）不算新的一次
+        if (yawning) {
+            if (m_lastYawnNs < 0
+                || nowNs - m_lastYawnNs > static_cast<int64_t>(m_options.yawnGapMs) * kNsPerMs) {
+                m_yawns.add(1);
+            }
+            m_lastYawnNs = nowNs;
+        }
+    } else {
+        // 看不到人脸时不计观测，闭眼就此中断
+        m_closureStartNs = -1;
+    }
+
+    const int64_t observedNs = m_observed.sum();
+    m_metrics.observedMs = observedNs / 1e6;
+    m_metrics.perclos = observedNs >= static_cast<int64_t>(m_options.minObservationMs) * kNsPerMs
+                            ? static_cast<double>(m_closed.sum()) / observedNs
+                            : 0.0;
+    m_metrics.yawns = static_cast<int>(m_yawns.sum());
+    m_metrics.longestClosureMs = m_closed.max() / 1e6;
+
+    // 升级立即生效；降级需指标持续低于当前等级 recoveryMs
+    const FatigueLevel target = evaluate();
+    if (target > m_level) {
+        m_recoverSinceNs = -1;
+    } else if (target < m_level) {
+        if (m_recoverSinceNs < 0) {
+            m_recoverSinceNs = nowNs;
+        }
+        if (nowNs - m_recoverSinceNs < static_cast<int64_t>(m_options.recoveryMs) * kNsPerMs) {
+            return false;
+        }
+        m_recoverSinceNs = -1;
+    } else {
+        m_recoverSinceNs = -1;
+        return false;
+    }
+
+    m_lastEvent.previous = m_level;
+    m_lastEvent.level = target;
+    m_lastEvent.timestampNs = nowNs;
+    m_lastEvent.metrics = m_metrics;
+    m_level = target;
+    return true;
+}
+
+FatigueLevel FatigueMonitor::evaluate() const
+{
+    if (m_metrics.perclos >= m_options.criticalPerclos
+        || m_metrics.yawns >= m_options.criticalYawns
+        || m_metrics.longestClosureMs >= m_options.criticalClosureMs) {
+        return FatigueLevel::Critical;
+    }
+    if (m_metrics.perclos >= m_options.drowsyPerclos
+        || m_metrics.yawns >= m_options.drowsyYawns
+        || m_metrics.longestClosureMs >= m_options.drowsyClosureMs) {
+        return FatigueLevel::Drowsy;
+    }
+    return FatigueLevel::Alert;
+}
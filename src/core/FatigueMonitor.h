@@ -0,0 +1,128 @@
+#ifndef FATIGUEMONITOR_H
+#define FATIGUEMONITOR_H
+
+#include <QMetaType>
+#include <cstdint>
+#include <vector>
+#include "FrameResult.h"
+
+// 疲劳判定配置
+struct FatigueOptions {
+    int perclosWindowMs = 60000;        // PERCLOS（闭眼时间占比）的统计窗口
+    int yawnWindowMs = 300000;          // 哈欠次数的统计窗口
+    int minObservationMs = 10000;       // 窗口内看到人脸的时间不足时 PERCLOS 不参与判定
+    double drowsyPerclos = 0.15;
+    double criticalPerclos = 0.30;
+    int drowsyYawns = 3;
+    int criticalYawns = 5;
+    int drowsyClosureMs = 1000;         // PERCLOS 窗口内最长一次闭眼
+    int criticalClosureMs = 2000;
+    int recoveryMs = 5000;              // 降级前指标需持续低于阈值的时间
+    int yawnGapMs = 1000;               // 哈欠中断不足此时长视为同一次
+    int maxFrameGapMs = 500;            // 帧间隔超过此值（丢帧、无人脸）时只按此值计入观测
+    int minHits = 2;                    // 轨迹匹配到这么多次检测才算驾驶员，与 TrackerOptions::minHits 一致
+};
+
+enum class FatigueLevel {
+    Alert,
+    Drowsy,
+    Critical
+};
+
+const char* fatigueLevelName(FatigueLevel level);
+
+// 当前窗口内的疲劳指标
+struct FatigueMetrics {
+    double perclos = 0.0;               // 观测不足 minObservationMs 时为 0
+    int yawns = 0;
+    double longestClosureMs = 0.0;      // PERCLOS 窗口内最长一次闭眼（含正在进行的）
+    double observedMs = 0.0;            // PERCLOS 窗口内看到人脸的时间
+};
+
+// 状态切换事件，只有它需要写数据库和通知界面
+struct FatigueEvent {
+    FatigueLevel previous = FatigueLevel::Alert;
+    FatigueLevel level = FatigueLevel::Alert;
+    int64_t timestampNs = 0;            // 触发切换的帧的采集时刻（steady_clock）
+    FatigueMetrics metrics;
+};
+
+Q_DECLARE_METATYPE(FatigueEvent)
+
+// 固定桶数的时间滑动窗口：值累加到当前时刻所在的桶，桶过期时从总和中减去。
+// 每次更新均摊 O(1)，configure() 之后不再分配内存
+class SlidingWindow
+{
+public:
+    void configure(int64_t windowNs, int buckets);
+    void reset();
+
+    // 推进到 timestampNs，移出过期的桶；时间回退时停留在当前桶
+    void advance(int64_t timestampNs);
+    void add(int64_t value);
+    // 当前桶的最大值至少为 value
+    void raiseMax(int64_t value);
+
+    int64_t sum() const { return m_sum; }
+    int64_t max() const { return m_max; }
+
+private:
+    struct Bucket {
+        int64_t sum = 0;
+        int64_t max = 0;
+    };
+    std::vector<Bucket> m_buckets;
+    int64_t m_bucketNs = 1;
+    int64_t m_head = -1;                // 最新桶的绝对序号（时间 / 桶宽）
+    int64_t m_sum = 0;
+    int64_t m_max = 0;
+};
+
+// 疲劳状态引擎：逐帧输入跟踪后的检测结果，取最可信的已确认人脸，
+// 用滑动窗口维护 PERCLOS、哈欠次数和最长闭眼时长，得出 清醒/疲劳/严重疲劳。
+// 升级立即生效，降级需指标持续 recoveryMs 低于阈值。只在输出线程中使用
+class FatigueMonitor
+{
+public:
+    explicit FatigueMonitor(const FatigueOptions& options = FatigueOptions());
+
+    // 传入的配置先经 validated() 修正
+    void setOptions(const FatigueOptions& options);
+    const FatigueOptions& options() const { return m_options; }
+    // 修正不合理的配置并输出调整：窗口至少 1 秒，时长和次数不为负，
+    // 疲劳阈值高于严重疲劳阈值时降到严重疲劳阈值
+    static FatigueOptions validated(const FatigueOptions& options);
+    // 闭眼和哈欠对应的类别 ID，取自引擎池
+    void setClassRoles(const ClassRoles& roles);
+    // 清空窗口，回到清醒状态
+    void reset();
+
+    // 返回 true 表示本帧触发了状态切换，事件由 lastEvent() 取得
+    bool update(const FrameResult& result);
+
+    FatigueLevel level() const { return m_level; }
+    const FatigueMetrics& metrics() const { return m_metrics; }
+    const FatigueEvent& lastEvent() const { return m_lastEvent; }
+
+private:
+    FatigueLevel evaluate() const;
+
+    FatigueOptions m_options;
+    int m_closedClass;
+    int m_yawnClass;
+
+    SlidingWindow m_observed;           // 看到人脸的时间（纳秒）
+    SlidingWindow m_closed;             // 其中闭眼的时间，桶最大值记录闭眼时长
+    SlidingWindow m_yawns;              // 哈欠开始的次数
+
+    int64_t m_lastFrameNs;
+    int64_t m_closureStartNs;           // 正在进行的闭眼的开始时刻，-1 表示睁眼
+    int64_t m_lastYawnNs;               // 最近一帧哈欠的时刻
+    int64_t m_recoverSinceNs;           // 指标开始低于当前等级的时刻，-1 表示未在恢复
+
+    FatigueLevel m_level;
+    FatigueMetrics m_metrics;
+    FatigueEvent m_lastEvent;
+};
+
+#endif // FATIGUEMONITOR_H
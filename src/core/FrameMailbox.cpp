@@ -0,0 +1,68 @@
+#include "FrameMailbox.h"
+#include <utility>
+
+FrameMailbox::FrameMailbox()
+    : m_posted(0)
+    , m_taken(0)
+    , m_dropped(0)
+{
+}
+
+void FrameMailbox::post(const FrameHandle& frame, const FrameResult& result)
+{
+    FrameHandle previous = frame;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_frame) {
+            ++m_dropped;
+        }
+        // 交换句柄，被覆盖的帧在锁外归还到池
+        std::swap(previous, m_frame);
+        m_result = result;
+        ++m_posted;
+    }
+}
+
+bool FrameMailbox::take(FrameHandle& frame, FrameResult& result)
+{
+    FrameHandle previous;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_frame) {
+            return false;
+        }
+        previous = std::move(frame);
+        frame = std::move(m_frame);
+        result = m_result;
+        ++m_taken;
+    }
+    return true;
+}
+
+void FrameMailbox::reset()
+{
+    FrameHandle previous;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    previous = std::move(m_frame);
+    m_posted = 0;
+    m_taken = 0;
+    m_dropped = 0;
+}
+
+uint64_t FrameMailbox::postedFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_posted;
+}
+
+uint64_t FrameMailbox::takenFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_taken;
+}
+
+uint64_t FrameMailbox::droppedFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
@@ -0,0 +1,38 @@
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include "FramePool.h"
+#include "FrameResult.h"
+#include <cstdint>
+#include <mutex>
+
+// 输出线程与界面之间的单槽信箱：新帧直接覆盖未取走的旧帧，
+// 界面按自己的刷新节拍取最新一帧，界面卡顿时积压最多一帧
+class FrameMailbox
+{
+public:
+    FrameMailbox();
+
+    // 放入一帧及其检测结果；上一帧尚未被取走时被覆盖并计入丢弃数
+    void post(const FrameHandle& frame, const FrameResult& result);
+
+    // 取走最新一帧及其检测结果；没有新帧时返回 false
+    bool take(FrameHandle& frame, FrameResult& result);
+
+    // 清空槽位（缓冲区归还到池）和计数，新的视频源开始前调用
+    void reset();
+
+    uint64_t postedFrames() const;
+    uint64_t takenFrames() const;
+    uint64_t droppedFrames() const;
+
+private:
+    mutable std::mutex m_mutex;
+    FrameHandle m_frame;
+    FrameResult m_result;
+    uint64_t m_posted;
+    uint64_t m_taken;
+    uint64_t m_dropped;
+};
+
+#endif // FRAMEMAILBOX_H
@@ -0,0 +1,70 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <thread>
+
+FramePacer::FramePacer()
+{
+    reset(DEFAULT_FPS, Mode::EveryFrame);
+}
+
+void FramePacer::reset(double fps, Mode mode)
+{
+    // 部分后端对网络流或损坏文件返回 0 或 1000 之类的值
+    m_fps = (fps > 1.0 && fps <= 240.0) ? fps : DEFAULT_FPS;
+    m_mode = mode;
+    m_frameInterval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / m_fps));
+
+    m_started = false;
+    m_originMediaMs = 0.0;
+    m_lastMediaMs = 0.0;
+    m_maxConsecutiveSkips = std::max(1, static_cast<int>(m_fps / 4.0));
+    m_consecutiveSkips = 0;
+    m_skipped = 0;
+    m_reanchored = 0;
+}
+
+bool FramePacer::schedule(double mediaMs)
+{
+    return schedule(mediaMs, Clock::now());
+}
+
+bool FramePacer::schedule(double mediaMs, Clock::time_point now)
+{
+    // 时间戳缺失或不递增时按帧率推算
+    if (mediaMs < 0.0 || (m_started && mediaMs <= m_lastMediaMs)) {
+        mediaMs = m_started ? m_lastMediaMs + 1000.0 / m_fps : 0.0;
+    }
+    m_lastMediaMs = mediaMs;
+
+    if (!m_started) {
+        m_started = true;
+        m_origin = now;
+        m_originMediaMs = mediaMs;
+    }
+
+    m_deadline = m_origin + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(mediaMs - m_originMediaMs));
+
+    const Clock::duration lateness = now - m_deadline;
+    if (lateness > m_frameInterval) {
+        if (m_mode == Mode::RealTime && m_consecutiveSkips < m_maxConsecutiveSkips) {
+            ++m_consecutiveSkips;
+            ++m_skipped;
+            return false;
+        }
+        // 逐帧模式，或实时模式丢帧后仍落后：整体后移时钟，之后按原帧率继续
+        m_consecutiveSkips = 0;
+        m_origin += lateness;
+        m_deadline = now;
+        ++m_reanchored;
+        return true;
+    }
+    m_consecutiveSkips = 0;
+    return true;
+}
+
+void FramePacer::waitUntilDue() const
+{
+    std::this_thread::sleep_until(m_deadline);
+}
@@ -0,0 +1,59 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <cstdint>
+
+// 视频文件的帧调度：按帧时间戳和源帧率计算每帧的绝对截止时刻，
+// 而不是处理完一帧后固定等待，处理耗时不会累积成额外延迟
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode {
+        RealTime,       // 落后超过一帧时丢弃已解码的帧以追上实时；连续丢弃约 1/4 秒仍追不上
+                        // （解码本身比源帧率慢）时重新对齐时钟，画面降帧而不是停住
+        EveryFrame      // 每帧都处理；落后时重新对齐时钟，不加速追赶
+    };
+
+    FramePacer();
+
+    // fps 无效（<=0 或异常大）时按 30fps
+    void reset(double fps, Mode mode);
+
+    // 读到一帧后调用：mediaMs 为帧时间戳（CAP_PROP_POS_MSEC，<0 表示未知，按帧率推算）
+    // 返回 false 表示实时模式下已落后，应丢弃该帧
+    bool schedule(double mediaMs);
+    // 同上，当前时刻由调用方给出（回放和基准用虚拟时钟检验调度决策）
+    bool schedule(double mediaMs, Clock::time_point now);
+
+    // 睡到当前帧的截止时刻（已过则立即返回）
+    void waitUntilDue() const;
+    Clock::time_point deadline() const { return m_deadline; }
+
+    double fps() const { return m_fps; }
+    Mode mode() const { return m_mode; }
+    uint64_t skippedFrames() const { return m_skipped; }
+    uint64_t reanchorCount() const { return m_reanchored; }
+
+    static constexpr double DEFAULT_FPS = 30.0;
+
+private:
+    double m_fps;
+    Mode m_mode;
+    Clock::duration m_frameInterval;
+
+    bool m_started;
+    Clock::time_point m_origin;     // 第一帧对应的墙钟时刻
+    double m_originMediaMs;         // 第一帧的时间戳
+    double m_lastMediaMs;
+    Clock::time_point m_deadline;
+    int m_maxConsecutiveSkips;
+    int m_consecutiveSkips;
+
+    uint64_t m_skipped;
+    uint64_t m_reanchored;
+};
+
+#endif // FRAMEPACER_H
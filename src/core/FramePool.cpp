@@ -0,0 +1,168 @@
+#include "FramePool.h"
+
+struct FrameHandle::Slot {
+    cv::Mat storage;                    // 池分配的缓冲区，生命周期与池相同
+    cv::Mat mat;                        // 对外的视图，归还时重置为 storage
+    std::atomic<int> refs{0};
+    std::shared_ptr<FramePool> owner;   // 借出期间保持池存活
+};
+
+FrameHandle::FrameHandle(Slot* slot)
+    : m_slot(slot)
+{
+}
+
+FrameHandle::FrameHandle(const FrameHandle& other)
+    : m_slot(other.m_slot)
+{
+    if (m_slot) {
+        m_slot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameHandle::FrameHandle(FrameHandle&& other) noexcept
+    : m_slot(other.m_slot)
+{
+    other.m_slot = nullptr;
+}
+
+FrameHandle& FrameHandle::operator=(const FrameHandle& other)
+{
+    if (m_slot != other.m_slot) {
+        if (other.m_slot) {
+            other.m_slot->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        reset();
+        m_slot = other.m_slot;
+    }
+    return *this;
+}
+
+FrameHandle& FrameHandle::operator=(FrameHandle&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        m_slot = other.m_slot;
+        other.m_slot = nullptr;
+    }
+    return *this;
+}
+
+FrameHandle::~FrameHandle()
+{
+    reset();
+}
+
+cv::Mat& FrameHandle::mat()
+{
+    return m_slot->mat;
+}
+
+const cv::Mat& FrameHandle::mat() const
+{
+    return m_slot->mat;
+}
+
+bool FrameHandle::empty() const
+{
+    return m_slot == nullptr;
+}
+
+void FrameHandle::reset()
+{
+    Slot* slot = m_slot;
+    m_slot = nullptr;
+    if (slot && slot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // 先取出池的引用再归还：若这是池的最后一个引用，池在归还完成后才析构
+        std::shared_ptr<FramePool> owner = std::move(slot->owner);
+        owner->giveBack(slot);
+    }
+}
+
+std::shared_ptr<FramePool> FramePool::create(cv::Size size, int type, size_t initialCount)
+{
+    std::shared_ptr<FramePool> pool(new FramePool(size, type));
+    std::lock_guard<std::mutex> lock(pool->m_mutex);
+    for (size_t i = 0; i < initialCount; ++i) {
+        pool->m_idle.push_back(pool->newSlot());
+    }
+    return pool;
+}
+
+FramePool::FramePool(cv::Size size, int type)
+    : m_size(size)
+    , m_type(type)
+    , m_acquired(0)
+    , m_reallocated(0)
+{
+}
+
+FramePool::~FramePool() = default;
+
+FrameHandle FramePool::acquire()
+{
+    FrameHandle::Slot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_idle.empty()) {
+            slot = newSlot();
+        } else {
+            slot = m_idle.back();
+            m_idle.pop_back();
+        }
+        ++m_acquired;
+    }
+
+    slot->owner = shared_from_this();
+    slot->refs.store(1, std::memory_order_relaxed);
+    return FrameHandle(slot);
+}
+
+FrameHandle::Slot* FramePool::newSlot()
+{
+    // 调用方已持有 m_mutex
+    auto slot = std::make_unique<FrameHandle::Slot>();
+    slot->storage.create(m_size, m_type);
+    slot->mat = slot->storage;
+    m_slots.push_back(std::move(slot));
+    // 空闲表容量跟随缓冲区总数，归还时不会再扩容
+    m_idle.reserve(m_slots.size());
+    return m_slots.back().get();
+}
+
+void FramePool::giveBack(FrameHandle::Slot* slot)
+{
+    // 使用方可能把尺寸不同的数据写进了 mat（如视频中途改变分辨率），此时 mat 已指向新内存
+    const bool reallocated = slot->mat.data != slot->storage.data;
+    slot->mat = slot->storage;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (reallocated) {
+        ++m_reallocated;
+    }
+    m_idle.push_back(slot);
+}
+
+uint64_t FramePool::allocatedBuffers() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_slots.size();
+}
+
+uint64_t FramePool::acquiredFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_acquired;
+}
+
+size_t FramePool::idleBuffers() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_idle.size();
+}
+
+uint64_t FramePool::reallocatedFrames() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_reallocated;
+}
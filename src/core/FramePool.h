@@ -0,0 +1,82 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class FramePool;
+
+// 池中帧的引用计数句柄：拷贝只增加计数，最后一个句柄释放时缓冲区回到池中。
+// 不要在句柄之外保留 mat() 的浅拷贝，缓冲区归还后会被下一帧覆盖。
+class FrameHandle
+{
+public:
+    FrameHandle() = default;
+    FrameHandle(const FrameHandle& other);
+    FrameHandle(FrameHandle&& other) noexcept;
+    FrameHandle& operator=(const FrameHandle& other);
+    FrameHandle& operator=(FrameHandle&& other) noexcept;
+    ~FrameHandle();
+
+    cv::Mat& mat();
+    const cv::Mat& mat() const;
+    bool empty() const;
+    explicit operator bool() const { return !empty(); }
+
+    void reset();
+
+private:
+    friend class FramePool;
+    struct Slot;
+    explicit FrameHandle(Slot* slot);
+
+    Slot* m_slot = nullptr;
+};
+
+// 固定尺寸、预分配的帧缓冲池。
+// 池耗尽时按需扩容（计入 allocatedBuffers），稳态下帧的流转不再分配堆内存。
+// 必须通过 create() 以 shared_ptr 持有：借出的缓冲区会让池一直存活到最后一个句柄释放。
+class FramePool : public std::enable_shared_from_this<FramePool>
+{
+public:
+    static std::shared_ptr<FramePool> create(cv::Size size, int type, size_t initialCount);
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 借出一块缓冲区，内容为上一次使用留下的数据
+    FrameHandle acquire();
+
+    cv::Size size() const { return m_size; }
+    int type() const { return m_type; }
+
+    // 统计：累计创建的缓冲区数、借出次数、当前空闲数、被外部改变尺寸后重建的次数
+    uint64_t allocatedBuffers() const;
+    uint64_t acquiredFrames() const;
+    size_t idleBuffers() const;
+    uint64_t reallocatedFrames() const;
+
+private:
+    FramePool(cv::Size size, int type);
+
+    FrameHandle::Slot* newSlot();
+    void giveBack(FrameHandle::Slot* slot);
+
+    friend class FrameHandle;
+
+    const cv::Size m_size;
+    const int m_type;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<FrameHandle::Slot>> m_slots;
+    std::vector<FrameHandle::Slot*> m_idle;
+    uint64_t m_acquired;
+    uint64_t m_reallocated;
+};
+
+#endif // FRAMEPOOL_H
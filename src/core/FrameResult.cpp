@@ -0,0 +1,22 @@
+#include "FrameResult.h"
+#include "DetectionEngine.h"
+#include <algorithm>
+
+void FrameResult::assign(const std::vector<Detection>& source)
+{
+    // NMS 输出已按置信度降序，截断时保留高分框
+    count = static_cast<int>(std::min<size_t>(source.size(), MAX_DETECTIONS));
+    for (int i = 0; i < count; ++i) {
+        const Detection& det = source[i];
+        FrameDetection& out = detections[i];
+        out.x = static_cast<float>(det.bbox.x);
+        out.y = static_cast<float>(det.bbox.y);
+        out.width = static_cast<float>(det.bbox.width);
+        out.height = static_cast<float>(det.bbox.height);
+        out.score = det.confidence;
+        out.classId = det.classId;
+        out.trackId = -1;
+        out.trackHits = 0;
+        out.trackMisses = 0;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef FRAMERESULT_H
+#define FRAMERESULT_H
+
+#include <QMetaType>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+struct Detection;
+
+// 检测类别在疲劳判定中的含义（类别 ID，-1 表示模型没有该类别），由 DetectionEngine 定义
+struct ClassRoles {
+    int eyesClosed = -1;
+    int yawn = -1;
+    int normal = -1;
+};
+
+// 单个检测框，坐标为 FrameResult::imageWidth x imageHeight 图像上的像素坐标
+struct FrameDetection {
+    float x;
+    float y;
+    float width;
+    float height;
+    float score;
+    int classId;
+    int trackId;                // 跟踪器分配的持久 ID，未跟踪时为 -1
+    int trackHits;              // 该轨迹累计匹配到检测的次数
+    int trackMisses;            // 该轨迹连续未匹配的推理次数；>0 时框是外推的，类别沿用丢失前的
+};
+
+// 每帧的检测结果：定长、可平凡拷贝，入队出队只是一次 memcpy，不含需要深拷贝的成员。
+// 作为排队信号的参数时 Qt 仍会在堆上复制一份
+// 数据库、告警等消费者只需要它，不需要图像和绘制
+struct FrameResult {
+    static constexpr int MAX_DETECTIONS = 32;
+
+    uint64_t frameId;
+    int64_t captureNs;          // 采集完成时刻（steady_clock）
+    int64_t resultNs;           // 推理完成时刻（steady_clock）
+    int imageWidth;
+    int imageHeight;
+    int count;                  // 有效检测数，超出 MAX_DETECTIONS 的低分框被截断
+    bool reused;                // 本帧未推理，检测框由跟踪器预测
+    bool inferred;              // 本帧调用了检测模型（关闭检测时为 false）
+    FrameDetection detections[MAX_DETECTIONS];
+
+    // 按置信度从高到低填入 detections 和 count，其余字段由调用方设置
+    void assign(const std::vector<Detection>& source);
+};
+
+static_assert(std::is_trivially_copyable<FrameResult>::value,
+              "FrameResult 需要可平凡拷贝");
+
+Q_DECLARE_METATYPE(FrameResult)
+
+#endif // FRAMERESULT_H
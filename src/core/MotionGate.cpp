@@ -0,0 +1,143 @@
+#include "MotionGate.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+MotionGate::MotionGate(const MotionGateOptions& options)
+    : m_options(options)
+    , m_hasReference(false)
+    , m_lastInferNs(0)
+    , m_lastChange(-1.0)
+    , m_evaluated(0)
+    , m_skipped(0)
+    , m_totalNs(0)
+{
+}
+
+void MotionGate::setOptions(const MotionGateOptions& options)
+{
+    m_options = options;
+}
+
+void MotionGate::reset()
+{
+    m_hasReference = false;
+    m_lastChange = -1.0;
+    m_evaluated.store(0, std::memory_order_relaxed);
+    m_skipped.store(0, std::memory_order_relaxed);
+    m_totalNs.store(0, std::memory_order_relaxed);
+}
+
+double MotionGate::averageCostMs() const
+{
+    const uint64_t frames = m_evaluated.load(std::memory_order_relaxed);
+    return frames > 0 ? m_totalNs.load(std::memory_order_relaxed) / 1e6 / frames : 0.0;
+}
+
+bool MotionGate::shouldInfer(const cv::Mat& frame, int64_t timestampNs)
+{
+    if (!m_options.enabled || frame.empty()) {
+        return true;
+    }
+
+    const int64_t startNs = steadyNowNs();
+    makeThumbnail(frame, m_current);
+
+    bool infer = true;
+    if (m_hasReference && m_current.size() == m_reference.size()) {
+        m_lastChange = maxBlockDifference(m_current, m_reference, BLOCK_SIZE);
+        const bool refreshDue = timestampNs - m_lastInferNs
+                                >= static_cast<int64_t>(m_options.refreshIntervalMs) * 1000000;
+        infer = refreshDue || m_lastChange >= m_options.threshold;
+    } else {
+        m_lastChange = -1.0;
+    }
+
+    // 参考帧始终是上次推理的帧，缓慢漂移会累积到超过门限
+    if (infer) {
+        std::swap(m_reference, m_current);
+        m_hasReference = true;
+        m_lastInferNs = timestampNs;
+    } else {
+        m_skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_evaluated.fetch_add(1, std::memory_order_relaxed);
+    m_totalNs.fetch_add(static_cast<uint64_t>(steadyNowNs() - startNs), std::memory_order_relaxed);
+    return infer;
+}
+
+void MotionGate::makeThumbnail(const cv::Mat& frame, cv::Mat& thumbnail)
+{
+    // 宽固定、高按比例，均取块大小的整数倍
+    const int height = std::max(BLOCK_SIZE,
+                                frame.rows * THUMBNAIL_WIDTH / std::max(1, frame.cols)
+                                    / BLOCK_SIZE * BLOCK_SIZE);
+    const cv::Size size(THUMBNAIL_WIDTH, height);
+
+    // 先缩小再转灰度，颜色转换只在缩略图上做
+    switch (frame.type()) {
+    case CV_8UC1:
+        cv::resize(frame, thumbnail, size, 0, 0, cv::INTER_AREA);
+        break;
+    case CV_8UC2:
+        // YUYV：通道 0 即亮度，缩小后取出即可
+        cv::resize(frame, m_scaled, size, 0, 0, cv::INTER_AREA);
+        cv::extractChannel(m_scaled, thumbnail, 0);
+        break;
+    case CV_8UC4:
+        cv::resize(frame, m_scaled, size, 0, 0, cv::INTER_AREA);
+        cv::cvtColor(m_scaled, thumbnail, cv::COLOR_BGRA2GRAY);
+        break;
+    default:
+        cv::resize(frame, m_scaled, size, 0, 0, cv::INTER_AREA);
+        cv::cvtColor(m_scaled, thumbnail, cv::COLOR_BGR2GRAY);
+        break;
+    }
+}
+
+double MotionGate::maxBlockDifference(const cv::Mat& a, const cv::Mat& b, int blockSize)
+{
+    CV_Assert(a.size() == b.size() && a.type() == CV_8UC1 && b.type() == CV_8UC1);
+
+    uint32_t maxSum = 0;
+    for (int by = 0; by + blockSize <= a.rows; by += blockSize) {
+        for (int bx = 0; bx + blockSize <= a.cols; bx += blockSize) {
+            uint32_t sum = 0;
+            int x0 = bx;
+#if CV_SIMD128
+            // 每行 16 字节一组求绝对差，按 uint16 累加（16 行 x 2 x 255 不会溢出）
+            for (; x0 + 16 <= bx + blockSize; x0 += 16) {
+                cv::v_uint16x8 acc = cv::v_setzero_u16();
+                for (int y = by; y < by + blockSize; ++y) {
+                    const cv::v_uint8x16 diff = cv::v_absdiff(cv::v_load(a.ptr<uchar>(y) + x0),
+                                                              cv::v_load(b.ptr<uchar>(y) + x0));
+                    cv::v_uint16x8 lo, hi;
+                    cv::v_expand(diff, lo, hi);
+                    acc = cv::v_add(acc, cv::v_add(lo, hi));
+                }
+                sum += cv::v_reduce_sum(acc);
+            }
+#endif
+            for (int y = by; y < by + blockSize; ++y) {
+                const uchar* rowA = a.ptr<uchar>(y);
+                const uchar* rowB = b.ptr<uchar>(y);
+                for (int x = x0; x < bx + blockSize; ++x) {
+                    sum += static_cast<uint32_t>(std::abs(rowA[x] - rowB[x]));
+                }
+            }
+            maxSum = std::max(maxSum, sum);
+        }
+    }
+    return static_cast<double>(maxSum) / (blockSize * blockSize);
+}
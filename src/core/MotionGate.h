@@ -0,0 +1,62 @@
+#ifndef MOTIONGATE_H
+#define MOTIONGATE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+
+// 变化门限配置
+struct MotionGateOptions {
+    bool enabled = true;
+    double threshold = 3.0;         // 块平均绝对差（灰度级）的最大值低于此值视为静止
+    int refreshIntervalMs = 200;    // 静止时最长多久强制推理一次
+};
+
+// 推理前的变化门限：把帧缩成灰度缩略图，与上次推理的缩略图按 16x16 块求平均绝对差。
+// 取最大块而不是全图平均，闭眼、张嘴这类局部变化不会被大面积静止背景稀释。
+// 只在推理线程中调用 shouldInfer()，统计可从其他线程读取
+class MotionGate
+{
+public:
+    explicit MotionGate(const MotionGateOptions& options = MotionGateOptions());
+
+    void setOptions(const MotionGateOptions& options);
+    const MotionGateOptions& options() const { return m_options; }
+    // 丢弃参考帧和统计，下一帧必定推理
+    void reset();
+
+    // 返回 true 表示该帧需要推理，并以它作为新的参考帧；
+    // 返回 false 时调用方沿用上次的检测结果。timestampNs 为该帧的采集时刻
+    bool shouldInfer(const cv::Mat& frame, int64_t timestampNs);
+
+    // 最近一次比较的变化量（最大块平均绝对差），没有参考帧时为 -1
+    double lastChange() const { return m_lastChange; }
+
+    uint64_t evaluatedFrames() const { return m_evaluated.load(std::memory_order_relaxed); }
+    uint64_t skippedFrames() const { return m_skipped.load(std::memory_order_relaxed); }
+    // 每帧门限判断的平均耗时
+    double averageCostMs() const;
+
+    // 两幅同尺寸灰度图按 blockSize x blockSize 分块，返回最大的块平均绝对差
+    static double maxBlockDifference(const cv::Mat& a, const cv::Mat& b, int blockSize);
+
+    static constexpr int THUMBNAIL_WIDTH = 320;
+    static constexpr int BLOCK_SIZE = 16;
+
+private:
+    void makeThumbnail(const cv::Mat& frame, cv::Mat& thumbnail);
+
+    MotionGateOptions m_options;
+    cv::Mat m_reference;        // 上次推理帧的缩略图
+    cv::Mat m_current;
+    cv::Mat m_scaled;           // 缩放后、转灰度前的缓冲
+    bool m_hasReference;
+    int64_t m_lastInferNs;
+    double m_lastChange;
+
+    std::atomic<uint64_t> m_evaluated;
+    std::atomic<uint64_t> m_skipped;
+    std::atomic<uint64_t> m_totalNs;
+};
+
+#endif // MOTIONGATE_H
@@ -0,0 +1,97 @@
+#include "NonMaxSuppression.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <numeric>
+
+void NonMaxSuppression::run(const std::vector<DecodedBox>& candidates, float iouThreshold,
+                            int topK, std::vector<int>& keep)
+{
+    keep.clear();
+    if (candidates.empty()) {
+        return;
+    }
+
+    // top-K 预选：只对前 K 个分数做排序
+    const int total = static_cast<int>(candidates.size());
+    const int count = (topK > 0) ? std::min(topK, total) : total;
+    m_order.resize(total);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    auto byScore = [&candidates](int a, int b) {
+        return candidates[a].score > candidates[b].score;
+    };
+    if (count < total) {
+        std::partial_sort(m_order.begin(), m_order.begin() + count, m_order.end(), byScore);
+    } else {
+        std::sort(m_order.begin(), m_order.end(), byScore);
+    }
+
+    // 转为 SoA，坐标按类别平移
+    m_x1.resize(count);
+    m_y1.resize(count);
+    m_x2.resize(count);
+    m_y2.resize(count);
+    m_area.resize(count);
+    m_suppressed.assign(count, 0.0f);
+    for (int k = 0; k < count; ++k) {
+        const DecodedBox& box = candidates[m_order[k]];
+        const float offset = box.classId * CLASS_OFFSET;
+        m_x1[k] = box.x1 + offset;
+        m_y1[k] = box.y1 + offset;
+        m_x2[k] = box.x2 + offset;
+        m_y2[k] = box.y2 + offset;
+        m_area[k] = std::max(0.0f, box.x2 - box.x1) * std::max(0.0f, box.y2 - box.y1);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (m_suppressed[i] != 0.0f) {
+            continue;
+        }
+        keep.push_back(m_order[i]);
+        suppressOverlaps(i, count, iouThreshold);
+    }
+}
+
+void NonMaxSuppression::suppressOverlaps(int i, int count, float iouThreshold)
+{
+    const float x1 = m_x1[i];
+    const float y1 = m_y1[i];
+    const float x2 = m_x2[i];
+    const float y2 = m_y2[i];
+    const float area = m_area[i];
+
+    int j = i + 1;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vx1 = cv::vx_setall_f32(x1);
+    const cv::v_float32 vy1 = cv::vx_setall_f32(y1);
+    const cv::v_float32 vx2 = cv::vx_setall_f32(x2);
+    const cv::v_float32 vy2 = cv::vx_setall_f32(y2);
+    const cv::v_float32 varea = cv::vx_setall_f32(area);
+    const cv::v_float32 vthreshold = cv::vx_setall_f32(iouThreshold);
+    const cv::v_float32 zero = cv::vx_setzero_f32();
+    const cv::v_float32 one = cv::vx_setall_f32(1.0f);
+
+    // IoU > t 等价于 inter > t * union，避免除法
+    for (; j <= count - lanes; j += lanes) {
+        cv::v_float32 w = cv::v_sub(cv::v_min(vx2, cv::vx_load(&m_x2[j])),
+                                    cv::v_max(vx1, cv::vx_load(&m_x1[j])));
+        cv::v_float32 h = cv::v_sub(cv::v_min(vy2, cv::vx_load(&m_y2[j])),
+                                    cv::v_max(vy1, cv::vx_load(&m_y1[j])));
+        cv::v_float32 inter = cv::v_mul(cv::v_max(w, zero), cv::v_max(h, zero));
+        cv::v_float32 uni = cv::v_sub(cv::v_add(varea, cv::vx_load(&m_area[j])), inter);
+        cv::v_float32 overlap = cv::v_gt(inter, cv::v_mul(vthreshold, uni));
+        cv::v_float32 suppressed = cv::vx_load(&m_suppressed[j]);
+        cv::v_store(&m_suppressed[j], cv::v_select(overlap, one, suppressed));
+    }
+#endif
+
+    for (; j < count; ++j) {
+        const float w = std::min(x2, m_x2[j]) - std::max(x1, m_x1[j]);
+        const float h = std::min(y2, m_y2[j]) - std::max(y1, m_y1[j]);
+        const float inter = std::max(w, 0.0f) * std::max(h, 0.0f);
+        const float uni = area + m_area[j] - inter;
+        if (inter > iouThreshold * uni) {
+            m_suppressed[j] = 1.0f;
+        }
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef NONMAXSUPPRESSION_H
+#define NONMAXSUPPRESSION_H
+
+#include "YoloDecoder.h"
+#include <vector>
+
+// 按类别的 NMS：候选框转为 SoA 布局，先按分数取 top-K，再用 SIMD 计算 IoU
+// 不同类别的框加上类别偏移后互不相交，一次遍历即可完成逐类别抑制
+class NonMaxSuppression
+{
+public:
+    NonMaxSuppression() = default;
+
+    // keep 输出保留框在 candidates 中的下标，按分数降序；topK <= 0 表示不限制
+    void run(const std::vector<DecodedBox>& candidates, float iouThreshold,
+             int topK, std::vector<int>& keep);
+
+    // 类别偏移，需大于模型输入坐标范围
+    static constexpr float CLASS_OFFSET = 4096.0f;
+
+private:
+    // 按分数排序后的 SoA 缓冲，逐帧复用
+    std::vector<int> m_order;
+    std::vector<float> m_x1;
+    std::vector<float> m_y1;
+    std::vector<float> m_x2;
+    std::vector<float> m_y2;
+    std::vector<float> m_area;
+    std::vector<float> m_suppressed;
+
+    void suppressOverlaps(int i, int count, float iouThreshold);
+};
+
+#endif // NONMAXSUPPRESSION_H
@@ -0,0 +1,226 @@
+#include "Preprocessor.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+
+namespace {
+
+constexpr float kNormScale = 1.0f / 255.0f;
+
+// BT.601 有限范围 YUV→RGB 系数（与 OpenCV 的 COLOR_YUV2BGR_YUYV 相同），已并入 1/255 归一化
+constexpr float kYScale = 1.164f / 255.0f;
+constexpr float kVToR = 1.596f / 255.0f;
+constexpr float kUToG = -0.391f / 255.0f;
+constexpr float kVToG = -0.813f / 255.0f;
+constexpr float kUToB = 2.018f / 255.0f;
+
+inline float clampUnit(float value)
+{
+    return std::min(1.0f, std::max(0.0f, value));
+}
+
+#if CV_SIMD
+// 16 个 uint8 展开为 4 组 float 并归一化后写出
+inline void storeNormalized(const cv::v_uint8& v, float* dst, const cv::v_float32& scale)
+{
+    const int n = cv::VTraits<cv::v_float32>::vlanes();
+    cv::v_uint16 lo, hi;
+    cv::v_expand(v, lo, hi);
+    cv::v_uint32 q0, q1, q2, q3;
+    cv::v_expand(lo, q0, q1);
+    cv::v_expand(hi, q2, q3);
+    cv::v_store(dst,         cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q0)), scale));
+    cv::v_store(dst + n,     cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q1)), scale));
+    cv::v_store(dst + 2 * n, cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q2)), scale));
+    cv::v_store(dst + 3 * n, cv::v_mul(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q3)), scale));
+}
+
+// 16 个 uint8 展开为 4 组 float 并减去偏移
+inline void expandWithOffset(const cv::v_uint8& v, cv::v_float32 out[4], const cv::v_float32& offset)
+{
+    cv::v_uint16 lo, hi;
+    cv::v_expand(v, lo, hi);
+    cv::v_uint32 q[4];
+    cv::v_expand(lo, q[0], q[1]);
+    cv::v_expand(hi, q[2], q[3]);
+    for (int i = 0; i < 4; ++i) {
+        out[i] = cv::v_sub(cv::v_cvt_f32(cv::v_reinterpret_as_s32(q[i])), offset);
+    }
+}
+
+inline cv::v_float32 clampUnit(const cv::v_float32& v, const cv::v_float32& zero,
+                               const cv::v_float32& one)
+{
+    return cv::v_min(one, cv::v_max(zero, v));
+}
+#endif
+
+} // namespace
+
+LetterboxInfo Preprocessor::letterboxToCHW(const cv::Mat& image, float* dst,
+                                           int dstWidth, int dstHeight)
+{
+    LetterboxInfo info;
+    if (image.empty() || dst == nullptr) {
+        return info;
+    }
+
+    info.scale = std::min(static_cast<float>(dstWidth) / image.cols,
+                          static_cast<float>(dstHeight) / image.rows);
+    info.scaledWidth = static_cast<int>(image.cols * info.scale);
+    info.scaledHeight = static_cast<int>(image.rows * info.scale);
+    info.padLeft = (dstWidth - info.scaledWidth) / 2;
+    info.padTop = (dstHeight - info.scaledHeight) / 2;
+    const bool needsResize = info.scaledWidth != image.cols || info.scaledHeight != image.rows;
+
+    const size_t planeSize = static_cast<size_t>(dstWidth) * dstHeight;
+    float* plane0 = dst;
+    float* plane1 = dst + planeSize;
+    float* plane2 = dst + 2 * planeSize;
+
+    // 只填充 letterbox 边框区域
+    fillPadding(plane0, dstWidth, dstHeight, info);
+    fillPadding(plane1, dstWidth, dstHeight, info);
+    fillPadding(plane2, dstWidth, dstHeight, info);
+
+    // YUYV 帧尺寸正好放进模型输入时，逐行转换颜色并直接写入平面
+    const bool yuyv = image.type() == CV_8UC2;
+    if (yuyv && !needsResize) {
+        for (int y = 0; y < info.scaledHeight; ++y) {
+            const size_t offset = static_cast<size_t>(y + info.padTop) * dstWidth + info.padLeft;
+            yuyvRowToPlanes(image.ptr<uchar>(y),
+                            plane0 + offset, plane1 + offset, plane2 + offset,
+                            info.scaledWidth);
+        }
+        return info;
+    }
+
+    // 灰度/BGRA/需要缩放的 YUYV 输入先转成 BGR
+    const cv::Mat* src = &image;
+    if (image.channels() != 3) {
+        cv::cvtColor(image, m_bgr, yuyv ? cv::COLOR_YUV2BGR_YUYV
+                                        : image.channels() == 1 ? cv::COLOR_GRAY2BGR
+                                                                : cv::COLOR_BGRA2BGR);
+        src = &m_bgr;
+    }
+
+    // 尺寸一致时跳过缩放，直接从原图读取
+    const cv::Mat* scaled = src;
+    if (needsResize) {
+        cv::resize(*src, m_scaled, cv::Size(info.scaledWidth, info.scaledHeight));
+        scaled = &m_scaled;
+    }
+
+    for (int y = 0; y < info.scaledHeight; ++y) {
+        const size_t offset = static_cast<size_t>(y + info.padTop) * dstWidth + info.padLeft;
+        bgrRowToPlanes(scaled->ptr<uchar>(y),
+                       plane0 + offset, plane1 + offset, plane2 + offset,
+                       info.scaledWidth);
+    }
+
+    return info;
+}
+
+void Preprocessor::fillPadding(float* plane, int width, int height, const LetterboxInfo& info)
+{
+    const int bottom = info.padTop + info.scaledHeight;
+    const int right = info.padLeft + info.scaledWidth;
+
+    // 上下边框整行填充
+    std::fill(plane, plane + static_cast<size_t>(info.padTop) * width, PAD_VALUE);
+    std::fill(plane + static_cast<size_t>(bottom) * width,
+              plane + static_cast<size_t>(height) * width, PAD_VALUE);
+
+    // 左右边框
+    if (info.padLeft == 0 && right == width) {
+        return;
+    }
+    for (int y = info.padTop; y < bottom; ++y) {
+        float* row = plane + static_cast<size_t>(y) * width;
+        std::fill(row, row + info.padLeft, PAD_VALUE);
+        std::fill(row + right, row + width, PAD_VALUE);
+    }
+}
+
+void Preprocessor::bgrRowToPlanes(const uchar* src, float* dst0, float* dst1,
+                                  float* dst2, int width)
+{
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const cv::v_float32 scale = cv::vx_setall_f32(kNormScale);
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_uint8 c0, c1, c2;
+        cv::v_load_deinterleave(src + x * 3, c0, c1, c2);
+        storeNormalized(c0, dst0 + x, scale);
+        storeNormalized(c1, dst1 + x, scale);
+        storeNormalized(c2, dst2 + x, scale);
+    }
+#endif
+    for (; x < width; ++x) {
+        dst0[x] = src[x * 3] * kNormScale;
+        dst1[x] = src[x * 3 + 1] * kNormScale;
+        dst2[x] = src[x * 3 + 2] * kNormScale;
+    }
+}
+
+void Preprocessor::yuyvRowToPlanes(const uchar* src, float* dst0, float* dst1,
+                                   float* dst2, int width)
+{
+    // 每 4 字节 Y0 U Y1 V 为相邻两个像素，共用一组色度
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int n = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 lumaOffset = cv::vx_setall_f32(16.0f);
+    const cv::v_float32 chromaOffset = cv::vx_setall_f32(128.0f);
+    const cv::v_float32 yScale = cv::vx_setall_f32(kYScale);
+    const cv::v_float32 vToR = cv::vx_setall_f32(kVToR);
+    const cv::v_float32 uToG = cv::vx_setall_f32(kUToG);
+    const cv::v_float32 vToG = cv::vx_setall_f32(kVToG);
+    const cv::v_float32 uToB = cv::vx_setall_f32(kUToB);
+    const cv::v_float32 zero = cv::vx_setzero_f32();
+    const cv::v_float32 one = cv::vx_setall_f32(1.0f);
+    for (; x <= width - 2 * lanes; x += 2 * lanes) {
+        cv::v_uint8 y0, u, y1, v;
+        cv::v_load_deinterleave(src + x * 2, y0, u, y1, v);
+        cv::v_float32 fy0[4], fu[4], fy1[4], fv[4];
+        expandWithOffset(y0, fy0, lumaOffset);
+        expandWithOffset(u, fu, chromaOffset);
+        expandWithOffset(y1, fy1, lumaOffset);
+        expandWithOffset(v, fv, chromaOffset);
+
+        for (int i = 0; i < 4; ++i) {
+            const cv::v_float32 l0 = cv::v_mul(fy0[i], yScale);
+            const cv::v_float32 l1 = cv::v_mul(fy1[i], yScale);
+            const cv::v_float32 r = cv::v_mul(fv[i], vToR);
+            const cv::v_float32 g = cv::v_muladd(fu[i], uToG, cv::v_mul(fv[i], vToG));
+            const cv::v_float32 b = cv::v_mul(fu[i], uToB);
+
+            // 偶数/奇数像素交错写回
+            const int offset = x + 2 * n * i;
+            cv::v_store_interleave(dst0 + offset, clampUnit(cv::v_add(l0, b), zero, one),
+                                   clampUnit(cv::v_add(l1, b), zero, one));
+            cv::v_store_interleave(dst1 + offset, clampUnit(cv::v_add(l0, g), zero, one),
+                                   clampUnit(cv::v_add(l1, g), zero, one));
+            cv::v_store_interleave(dst2 + offset, clampUnit(cv::v_add(l0, r), zero, one),
+                                   clampUnit(cv::v_add(l1, r), zero, one));
+        }
+    }
+#endif
+    for (; x + 1 < width; x += 2) {
+        const uchar* pair = src + x * 2;
+        const float l0 = (pair[0] - 16.0f) * kYScale;
+        const float l1 = (pair[2] - 16.0f) * kYScale;
+        const float u = pair[1] - 128.0f;
+        const float v = pair[3] - 128.0f;
+        const float r = v * kVToR;
+        const float g = u * kUToG + v * kVToG;
+        const float b = u * kUToB;
+        dst0[x] = clampUnit(l0 + b);
+        dst0[x + 1] = clampUnit(l1 + b);
+        dst1[x] = clampUnit(l0 + g);
+        dst1[x + 1] = clampUnit(l1 + g);
+        dst2[x] = clampUnit(l0 + r);
+        dst2[x + 1] = clampUnit(l1 + r);
+    }
+}
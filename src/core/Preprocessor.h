@@ -0,0 +1,45 @@
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+#include <opencv2/opencv.hpp>
+
+// letterbox 映射参数：模型输入坐标 = 原图坐标 * scale + pad
+struct LetterboxInfo {
+    float scale = 1.0f;
+    int padLeft = 0;
+    int padTop = 0;
+    int scaledWidth = 0;
+    int scaledHeight = 0;
+
+    // 逆映射：模型输入坐标 -> 原图坐标
+    float toSourceX(float x) const { return (x - padLeft) / scale; }
+    float toSourceY(float y) const { return (y - padTop) / scale; }
+};
+
+// 融合预处理：letterbox + 归一化(1/255) + HWC->CHW 一次写入模型输入张量
+// 输出平面顺序与原图通道顺序一致（BGR），填充值为 114/255。
+// CV_8UC2 输入按摄像头原始 YUYV 处理：无需缩放时颜色转换也在同一遍中完成
+class Preprocessor
+{
+public:
+    Preprocessor() = default;
+
+    // dst 需至少容纳 3 * dstHeight * dstWidth 个 float
+    LetterboxInfo letterboxToCHW(const cv::Mat& image, float* dst,
+                                 int dstWidth, int dstHeight);
+
+    static constexpr float PAD_VALUE = 114.0f / 255.0f;
+
+private:
+    cv::Mat m_scaled;   // 缩放结果，跨帧复用
+    cv::Mat m_bgr;      // 非3通道输入的转换缓冲
+
+    static void fillPadding(float* plane, int width, int height,
+                            const LetterboxInfo& info);
+    static void bgrRowToPlanes(const uchar* src, float* dst0, float* dst1,
+                               float* dst2, int width);
+    static void yuyvRowToPlanes(const uchar* src, float* dst0, float* dst1,
+                                float* dst2, int width);
+};
+
+#endif // PREPROCESSOR_H
@@ -0,0 +1,404 @@
+#include "ThreadPlacement.h"
+#include <QDebug>
+#include <QStringList>
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr size_t kRoleCount = static_cast<size_t>(ThreadRole::Count);
+
+// 调用过 apply() 的线程及当时的内核迁移计数
+struct PlacedThread {
+    long threadId;
+    int64_t migrationBase;
+};
+
+struct PlacementTable {
+    std::mutex mutex;
+    std::array<ThreadPlacementPolicy, kRoleCount> policies;
+    std::array<std::vector<PlacedThread>, kRoleCount> threads;
+
+    // 进程启动时的亲和性，未配置 CPU 的角色恢复为它。
+    // 首次访问发生在主线程 configure() 时，早于任何 apply()
+#if defined(Q_OS_LINUX)
+    cpu_set_t processMask;
+    bool hasProcessMask = false;
+    int processNice = 0;                // 如在 nice -n 10 下启动时为 10
+
+    PlacementTable()
+    {
+        CPU_ZERO(&processMask);
+        hasProcessMask = sched_getaffinity(0, sizeof(processMask), &processMask) == 0;
+        errno = 0;
+        const int nice = getpriority(PRIO_PROCESS, 0);
+        processNice = errno == 0 ? nice : 0;
+    }
+#elif defined(Q_OS_WIN)
+    DWORD_PTR processMask = 0;
+    int processPriority = THREAD_PRIORITY_NORMAL;
+
+    PlacementTable()
+    {
+        DWORD_PTR systemMask = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+            processMask = 0;
+        }
+        const int priority = GetThreadPriority(GetCurrentThread());
+        if (priority != THREAD_PRIORITY_ERROR_RETURN) {
+            processPriority = priority;
+        }
+    }
+#endif
+};
+
+PlacementTable& table()
+{
+    static PlacementTable instance;
+    return instance;
+}
+
+QString describe(const ThreadPlacementPolicy& policy)
+{
+    QStringList cpus;
+    for (int cpu : policy.cpus) {
+        cpus << QString::number(cpu);
+    }
+    return QString("cpus [%1] %2 priority %3")
+        .arg(cpus.isEmpty() ? QString("any") : cpus.join(','))
+        .arg(QString::fromStdString(policy.scheduler))
+        .arg(policy.priority);
+}
+
+} // namespace
+
+std::vector<int> ThreadPlacementPolicy::parseCpuList(const std::string& text)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        part.erase(std::remove_if(part.begin(), part.end(), ::isspace), part.end());
+        if (part.empty()) {
+            continue;
+        }
+        try {
+            const size_t dash = part.find('-');
+            int first = 0;
+            int last = 0;
+            if (dash == std::string::npos) {
+                first = last = std::stoi(part);
+            } else {
+                first = std::stoi(part.substr(0, dash));
+                last = std::stoi(part.substr(dash + 1));
+            }
+            // 范围限制在本机 CPU 数内，避免 "0-2000000000" 之类的输入展开成巨大列表
+            const int limit = ThreadPlacement::cpuLimit();
+            if (last >= limit || first < 0) {
+                qDebug() << "CPU list entry" << QString::fromStdString(part)
+                         << "limited to CPUs 0 -" << limit - 1;
+            }
+            for (int cpu = std::max(first, 0); cpu <= std::min(last, limit - 1); ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            qDebug() << "Ignoring invalid CPU list entry" << QString::fromStdString(part);
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+void ThreadPlacement::configure(ThreadRole role, const ThreadPlacementPolicy& policy)
+{
+    std::lock_guard<std::mutex> lock(table().mutex);
+    table().policies[static_cast<size_t>(role)] = policy;
+}
+
+ThreadPlacementPolicy ThreadPlacement::policy(ThreadRole role)
+{
+    std::lock_guard<std::mutex> lock(table().mutex);
+    return table().policies[static_cast<size_t>(role)];
+}
+
+bool ThreadPlacement::isConfigured(ThreadRole role)
+{
+    return !policy(role).isDefault();
+}
+
+const char* ThreadPlacement::roleName(ThreadRole role)
+{
+    switch (role) {
+    case ThreadRole::Ui:         return "ui";
+    case ThreadRole::Capture:    return "capture";
+    case ThreadRole::Inference:  return "inference";
+    case ThreadRole::IntraOp:    return "intra_op";
+    case ThreadRole::Output:     return "output";
+    case ThreadRole::Background: return "background";
+    default:                     return "unknown";
+    }
+}
+
+bool ThreadPlacement::apply(ThreadRole role)
+{
+    const ThreadPlacementPolicy placement = policy(role);
+    bool ok = true;
+
+#if defined(Q_OS_LINUX)
+    // 线程名便于在 top -H / perf 中区分（最长 15 个字符）
+    if (role != ThreadRole::Ui) {
+        const std::string name = std::string("fds-") + roleName(role);
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+    }
+
+    // 未配置 CPU 时恢复进程的亲和性，而不是沿用创建者（如已绑核的界面线程）的
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (!placement.cpus.empty()) {
+        for (int cpu : placement.cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+    } else if (table().hasProcessMask) {
+        set = table().processMask;
+    }
+    if (CPU_COUNT(&set) > 0) {
+        const int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (error != 0) {
+            qDebug() << "Thread placement:" << roleName(role) << "affinity failed, error" << error;
+            ok = false;
+        }
+    }
+
+    int policyId = SCHED_OTHER;
+    if (placement.scheduler == "fifo") {
+        policyId = SCHED_FIFO;
+    } else if (placement.scheduler == "rr") {
+        policyId = SCHED_RR;
+    } else if (placement.scheduler == "batch") {
+        policyId = SCHED_BATCH;
+    } else if (placement.scheduler == "idle") {
+        policyId = SCHED_IDLE;
+    }
+
+    const bool realtime = (policyId == SCHED_FIFO || policyId == SCHED_RR);
+    sched_param param{};
+    param.sched_priority = realtime ? std::clamp(placement.priority, 1, 99) : 0;
+    int currentPolicy = SCHED_OTHER;
+    sched_param currentParam{};
+    pthread_getschedparam(pthread_self(), &currentPolicy, &currentParam);
+    if (currentPolicy != policyId || currentParam.sched_priority != param.sched_priority) {
+        const int error = pthread_setschedparam(pthread_self(), policyId, &param);
+        if (error != 0) {
+            // 实时调度通常需要 CAP_SYS_NICE 或 RLIMIT_RTPRIO
+            qDebug() << "Thread placement:" << roleName(role) << "scheduler"
+                     << QString::fromStdString(placement.scheduler) << "failed, error" << error;
+            ok = false;
+        }
+    }
+
+    // nice 值在 Linux 上按线程生效；未配置时恢复为进程启动时的值，不会比用户要求的更高。
+    // 低于继承值（提高优先级）需要 CAP_SYS_NICE 或 RLIMIT_NICE，失败时如实报告
+    if (!realtime) {
+        const id_t threadId = static_cast<id_t>(currentThreadId());
+        const int nice = placement.priority != 0 ? std::clamp(placement.priority, -20, 19)
+                                                 : table().processNice;
+        errno = 0;
+        const int currentNice = getpriority(PRIO_PROCESS, threadId);
+        if ((errno != 0 || currentNice != nice) && setpriority(PRIO_PROCESS, threadId, nice) != 0) {
+            qDebug() << "Thread placement:" << roleName(role) << "nice" << nice << "failed";
+            ok = false;
+        }
+    }
+#elif defined(Q_OS_WIN)
+    DWORD_PTR mask = table().processMask;
+    if (!placement.cpus.empty()) {
+        mask = 0;
+        for (int cpu : placement.cpus) {
+            if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+                mask |= DWORD_PTR(1) << cpu;
+            }
+        }
+    }
+    if (mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        ok = false;
+    }
+
+    // 实时策略对应最高的非实时优先级；nice 值取反映射到优先级档位
+    int priority = table().processPriority;
+    if (placement.scheduler == "fifo" || placement.scheduler == "rr") {
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+    } else if (placement.scheduler == "idle") {
+        priority = THREAD_PRIORITY_IDLE;
+    } else if (placement.priority < 0) {
+        priority = placement.priority <= -10 ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_ABOVE_NORMAL;
+    } else if (placement.priority > 0) {
+        priority = placement.priority >= 10 ? THREAD_PRIORITY_LOWEST : THREAD_PRIORITY_BELOW_NORMAL;
+    }
+    if (GetThreadPriority(GetCurrentThread()) != priority
+        && !SetThreadPriority(GetCurrentThread(), priority)) {
+        ok = false;
+    }
+#else
+    if (!placement.isDefault()) {
+        qDebug() << "Thread placement is not supported on this platform";
+        ok = false;
+    }
+#endif
+
+    if (!placement.isDefault()) {
+        qDebug() << "Thread placement:" << roleName(role) << describe(placement)
+                 << (ok ? "applied" : "partially applied") << "- now on CPU" << currentCpu();
+    }
+
+    // 登记线程供 roleMigrations() 汇总
+    const long threadId = currentThreadId();
+    const int64_t base = kernelMigrations(threadId);
+    if (base >= 0) {
+        std::lock_guard<std::mutex> lock(table().mutex);
+        table().threads[static_cast<size_t>(role)].push_back({threadId, base});
+    }
+    return ok;
+}
+
+int64_t ThreadPlacement::roleMigrations(ThreadRole role)
+{
+    if (kernelMigrations(currentThreadId()) < 0) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(table().mutex);
+    std::vector<PlacedThread>& threads = table().threads[static_cast<size_t>(role)];
+    if (threads.empty()) {
+        return -1;
+    }
+    int64_t total = 0;
+    for (auto it = threads.begin(); it != threads.end();) {
+        const int64_t now = kernelMigrations(it->threadId);
+        if (now < 0) {
+            // 线程已退出（如上一次运行的流水线），不再统计
+            it = threads.erase(it);
+            continue;
+        }
+        total += std::max<int64_t>(0, now - it->migrationBase);
+        ++it;
+    }
+    return total;
+}
+
+int ThreadPlacement::currentCpu()
+{
+#if defined(Q_OS_LINUX)
+    return sched_getcpu();
+#elif defined(Q_OS_WIN)
+    return static_cast<int>(GetCurrentProcessorNumber());
+#else
+    return -1;
+#endif
+}
+
+int ThreadPlacement::cpuLimit()
+{
+    const int online = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+#if defined(Q_OS_LINUX)
+    const long configured = sysconf(_SC_NPROCESSORS_CONF);
+    return std::min<int>(CPU_SETSIZE, std::max<long>(online, configured));
+#elif defined(Q_OS_WIN)
+    return std::min(online, static_cast<int>(sizeof(DWORD_PTR) * 8));
+#else
+    return online;
+#endif
+}
+
+long ThreadPlacement::currentThreadId()
+{
+#if defined(Q_OS_LINUX)
+    return static_cast<long>(syscall(SYS_gettid));
+#elif defined(Q_OS_WIN)
+    return static_cast<long>(GetCurrentThreadId());
+#else
+    return 0;
+#endif
+}
+
+int64_t ThreadPlacement::kernelMigrations(long threadId)
+{
+#if defined(Q_OS_LINUX)
+    // 需要内核开启 CONFIG_SCHED_DEBUG
+    std::ifstream sched("/proc/self/task/" + std::to_string(threadId) + "/sched");
+    std::string line;
+    while (std::getline(sched, line)) {
+        if (line.compare(0, 17, "se.nr_migrations ") == 0) {
+            const size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                try {
+                    return std::stoll(line.substr(colon + 1));
+                } catch (const std::exception&) {
+                    return -1;
+                }
+            }
+        }
+    }
+#else
+    Q_UNUSED(threadId);
+#endif
+    return -1;
+}
+
+ThreadPlacement::Probe::Probe()
+    : m_threadId(0)
+    , m_lastCpu(-1)
+    , m_observed(0)
+    , m_kernelBase(-1)
+{
+}
+
+void ThreadPlacement::Probe::attach()
+{
+    const long threadId = currentThreadId();
+    m_threadId.store(threadId, std::memory_order_relaxed);
+    m_lastCpu.store(currentCpu(), std::memory_order_relaxed);
+    m_observed.store(0, std::memory_order_relaxed);
+    m_kernelBase.store(kernelMigrations(threadId), std::memory_order_relaxed);
+}
+
+void ThreadPlacement::Probe::sample()
+{
+    const int cpu = currentCpu();
+    if (cpu != m_lastCpu.load(std::memory_order_relaxed)) {
+        m_lastCpu.store(cpu, std::memory_order_relaxed);
+        m_observed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t ThreadPlacement::Probe::migrations() const
+{
+    const int64_t base = m_kernelBase.load(std::memory_order_relaxed);
+    if (base >= 0) {
+        const int64_t now = kernelMigrations(m_threadId.load(std::memory_order_relaxed));
+        if (now >= base) {
+            return static_cast<uint64_t>(now - base);
+        }
+    }
+    return m_observed.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,86 @@
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 需要单独放置的线程
+enum class ThreadRole {
+    Ui,             // 主线程
+    Capture,        // 采集/解码
+    Inference,      // 推理（预处理、后处理和 ORT 调用方）
+    IntraOp,        // ORT 算子内线程池
+    Output,         // 标注输出与数据库写入
+    Background,     // 初始化和模型热替换等后台任务
+    Count
+};
+
+// 单个角色的放置策略
+struct ThreadPlacementPolicy {
+    std::vector<int> cpus;              // 允许运行的 CPU，空表示不限制
+    std::string scheduler = "other";    // other / batch / idle / fifo / rr
+    int priority = 0;                   // other/batch 为 nice 值（-20..19，0 表示沿用进程启动时的值），
+                                        // fifo/rr 为实时优先级（1..99）
+
+    bool isDefault() const { return cpus.empty() && scheduler == "other" && priority == 0; }
+
+    // 解析 "0-3,6" 形式的 CPU 列表，忽略无法识别的部分和超出本机 CPU 数的编号
+    static std::vector<int> parseCpuList(const std::string& text);
+};
+
+// 线程放置：按角色设置 CPU 亲和性、调度策略和优先级。
+// Linux 使用 pthread/sched 接口，Windows 使用亲和性掩码和线程优先级，其他平台只记录不生效。
+// 策略在启动时配置一次，各线程启动后对自身调用 apply()。
+// 新线程继承创建者的亲和性和调度参数，apply() 会把角色未配置的项恢复：
+// 亲和性和 nice 值（Windows 为线程优先级）恢复为进程启动时的值，调度策略恢复为 SCHED_OTHER
+class ThreadPlacement
+{
+public:
+    static void configure(ThreadRole role, const ThreadPlacementPolicy& policy);
+    static ThreadPlacementPolicy policy(ThreadRole role);
+    static bool isConfigured(ThreadRole role);
+
+    // 对当前线程应用该角色的策略并设置线程名；部分失败（如无权限设置实时优先级）时返回 false
+    static bool apply(ThreadRole role);
+
+    static const char* roleName(ThreadRole role);
+
+    // 当前线程所在的 CPU，不支持时返回 -1
+    static int currentCpu();
+    // 本机可放置的 CPU 数（Linux 不超过 CPU_SETSIZE，Windows 不超过亲和性掩码位数）
+    static int cpuLimit();
+
+    // 调用过 apply() 且仍在运行的该角色线程自放置以来的迁移次数之和，
+    // 用于无法在线程内采样的角色（界面、ORT 算子线程）；内核计数不可用或没有登记的线程时返回 -1
+    static int64_t roleMigrations(ThreadRole role);
+
+    // 线程迁移观测：在所属线程内周期性调用 sample()，其他线程可读取结果
+    class Probe
+    {
+    public:
+        Probe();
+
+        // 在被观测线程内调用：记录线程 ID 并重置计数
+        void attach();
+        // 在被观测线程内调用：所在 CPU 与上次不同则计一次迁移
+        void sample();
+
+        // 内核统计的迁移次数（Linux 的 se.nr_migrations），不可用时返回观测到的次数
+        uint64_t migrations() const;
+        int lastCpu() const { return m_lastCpu.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<long> m_threadId;
+        std::atomic<int> m_lastCpu;
+        std::atomic<uint64_t> m_observed;
+        std::atomic<int64_t> m_kernelBase;  // attach 时内核计数，-1 表示不可用
+    };
+
+private:
+    static long currentThreadId();
+    static int64_t kernelMigrations(long threadId);
+};
+
+#endif // THREADPLACEMENT_H
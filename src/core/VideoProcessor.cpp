@@ -1,24 +1,85 @@
 #include "VideoProcessor.h"
-#include "DetectionEngine.h"
+#include "CaptureFormat.h"
+#include "DetectionEnginePool.h"
 #include "DatabaseManager.h"
 #include <QDebug>
 #include <QTimer>
-#include <QDateTime>
-#include <Windows.h>
-#include <qcoreapplication.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+namespace {
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 保持宽高比放入显示区域的尺寸；源不大于显示区域时不缩放
+cv::Size fitDisplaySize(const cv::Size& source, int displayWidth, int displayHeight)
+{
+    if (source.width <= displayWidth && source.height <= displayHeight) {
+        return source;
+    }
+    const double scale = std::min(static_cast<double>(displayWidth) / source.width,
+                                  static_cast<double>(displayHeight) / source.height);
+    return cv::Size(std::max(1, static_cast<int>(std::lround(source.width * scale))),
+                    std::max(1, static_cast<int>(std::lround(source.height * scale))));
+}
+
+} // namespace
+
+// 流水线中传递的帧，图像以池句柄传递，不复制像素
+struct CapturedFrame {
+    uint64_t id = 0;
+    int64_t captureNs = 0;      // 采集完成时刻（steady_clock）
+    FrameHandle image;          // 源分辨率，来自采集池
+};
+
+struct InferredFrame {
+    FrameHandle image;          // 源分辨率的原始帧，来自采集池
+    FrameResult result;         // 坐标对应 image
+};
+
+void VideoProcessorWorker::StageCounter::add(int64_t ns)
+{
+    frames.fetch_add(1, std::memory_order_relaxed);
+    totalNs.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+}
+
+double VideoProcessorWorker::StageCounter::averageMs() const
+{
+    const uint64_t n = frames.load(std::memory_order_relaxed);
+    return n ? totalNs.load(std::memory_order_relaxed) / 1e6 / n : 0.0;
+}
+
+void VideoProcessorWorker::StageCounter::reset()
+{
+    frames.store(0, std::memory_order_relaxed);
+    totalNs.store(0, std::memory_order_relaxed);
+}
 
 // VideoProcessorWorker 实现
 VideoProcessorWorker::VideoProcessorWorker()
     : m_running(false)
     , m_deviceId(0)
     , m_isDevice(false)
-    , m_detectionEngine(nullptr)
-    , m_dbManager(nullptr)
+    , m_isLiveStream(false)
+    , m_negotiateFormat(true)
+    , m_minCaptureFps(15.0)
+    , m_rawYuyv(false)
+    , m_pacingMode(FramePacer::Mode::EveryFrame)
+    , m_capturePolicy(QueuePolicy::DropOldest)
+    , m_outputPolicy(QueuePolicy::Block)
+    , m_queueCapacity(2)
+    , m_regionStreak(0)
+    , m_decodedFrames(0)
+    , m_skippedDecodes(0)
+    , m_enginePool(nullptr)
     , m_displayWidth(960)
     , m_displayHeight(540)
     , m_enableDetection(true)
-    , m_confidenceThreshold(0.6)
-    , m_saveInterval(1000)
 {
 }
 
@@ -34,22 +95,51 @@ void VideoProcessorWorker::setSource(const std::string& source)
 {
     m_source = source;
     m_isDevice = false;
+    // rtsp://、http:// 等网络地址按实时流处理
+    m_isLiveStream = source.find("://") != std::string::npos;
 }
 
 void VideoProcessorWorker::setDevice(int deviceId)
 {
     m_deviceId = deviceId;
     m_isDevice = true;
+    m_isLiveStream = true;
+}
+
+void VideoProcessorWorker::setPacingMode(FramePacer::Mode mode)
+{
+    m_pacingMode = mode;
+}
+
+void VideoProcessorWorker::setCaptureNegotiation(bool enabled, double minFps)
+{
+    m_negotiateFormat = enabled;
+    m_minCaptureFps = minFps;
+}
+
+void VideoProcessorWorker::setMotionGate(const MotionGateOptions& options)
+{
+    m_motionGateOptions = options;
+}
+
+void VideoProcessorWorker::setTracker(const TrackerOptions& options)
+{
+    m_trackerOptions = options;
 }
 
-void VideoProcessorWorker::setDetectionEngine(DetectionEngine* engine)
+void VideoProcessorWorker::setFatigueMonitor(const FatigueOptions& options)
 {
-    m_detectionEngine = engine;
+    m_fatigueOptions = options;
 }
 
-void VideoProcessorWorker::setDatabaseManager(DatabaseManager* dbManager)
+void VideoProcessorWorker::setEnginePool(DetectionEnginePool* pool)
 {
-    m_dbManager = dbManager;
+    m_enginePool = pool;
+}
+
+void VideoProcessorWorker::setDatabaseManager(std::shared_ptr<DatabaseManager> dbManager)
+{
+    std::atomic_store(&m_dbManager, std::move(dbManager));
 }
 
 void VideoProcessorWorker::setDisplaySize(int width, int height)
@@ -63,19 +153,92 @@ void VideoProcessorWorker::setEnableDetection(bool enable)
     m_enableDetection = enable;
 }
 
+void VideoProcessorWorker::setQueuePolicies(QueuePolicy capturePolicy, QueuePolicy outputPolicy)
+{
+    m_capturePolicy = capturePolicy;
+    m_outputPolicy = outputPolicy;
+}
+
+void VideoProcessorWorker::setQueueCapacity(int capacity)
+{
+    m_queueCapacity = std::max(1, capacity);
+}
+
+PipelineStats VideoProcessorWorker::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    return collectStats();
+}
+
+PipelineStats VideoProcessorWorker::collectStats() const
+{
+    PipelineStats stats;
+    stats.capturedFrames = m_captureCounter.frames.load(std::memory_order_relaxed);
+    stats.decodedFrames = m_decodedFrames.load(std::memory_order_relaxed);
+    stats.skippedDecodes = m_skippedDecodes.load(std::memory_order_relaxed);
+    stats.inferredFrames = m_inferenceCounter.frames.load(std::memory_order_relaxed);
+    stats.outputFrames = m_outputCounter.frames.load(std::memory_order_relaxed);
+    stats.captureMs = m_captureCounter.averageMs();
+    stats.inferenceMs = m_inferenceCounter.averageMs();
+    stats.outputMs = m_outputCounter.averageMs();
+    if (m_captureQueue) {
+        stats.captureQueueDepth = m_captureQueue->size();
+        stats.captureDropped = m_captureQueue->dropped();
+    }
+    if (m_outputQueue) {
+        stats.outputQueueDepth = m_outputQueue->size();
+        stats.outputDropped = m_outputQueue->dropped();
+    }
+    stats.displayedFrames = m_mailbox.takenFrames();
+    stats.displayDropped = m_mailbox.droppedFrames();
+    // 采集池可能被采集线程重建
+    if (std::shared_ptr<FramePool> pool = std::atomic_load(&m_capturePool)) {
+        stats.pooledBuffers += pool->allocatedBuffers();
+    }
+    if (std::shared_ptr<FramePool> pool = std::atomic_load(&m_displayPool)) {
+        stats.pooledBuffers += pool->allocatedBuffers();
+    }
+    stats.captureMigrations = m_captureProbe.migrations();
+    stats.inferenceMigrations = m_inferenceProbe.migrations();
+    stats.outputMigrations = m_outputProbe.migrations();
+    stats.uiMigrations = ThreadPlacement::roleMigrations(ThreadRole::Ui);
+    stats.intraOpMigrations = ThreadPlacement::roleMigrations(ThreadRole::IntraOp);
+    stats.gateEvaluated = m_motionGate.evaluatedFrames();
+    stats.gateSkipped = m_motionGate.skippedFrames();
+    stats.gateMs = m_motionGate.averageCostMs();
+    stats.modelMs = m_modelCounter.averageMs();
+    stats.fullFrames = m_fullFrameCounter.frames.load(std::memory_order_relaxed);
+    stats.regionFrames = m_regionCounter.frames.load(std::memory_order_relaxed);
+    stats.fullFrameMs = m_fullFrameCounter.averageMs();
+    stats.regionMs = m_regionCounter.averageMs();
+    stats.cascadeFrames = m_cascadeCounter.frames.load(std::memory_order_relaxed);
+    stats.cascadeMs = m_cascadeCounter.averageMs();
+    stats.predictedFrames = m_tracker.predictedFrames();
+    stats.activeTracks = m_tracker.activeTracks();
+    return stats;
+}
+
 void VideoProcessorWorker::start()
 {
     if (m_running) {
         return;
     }
 
+    // 回收上一次运行的线程（如视频文件播放结束后自行退出的流水线）
+    joinStages();
+
     // 打开视频源（在 Worker 线程中执行，不会阻塞 UI）
+    const int64_t openStartNs = steadyNowNs();
     bool success = false;
+    m_rawYuyv = false;
     if (m_isDevice) {
-        success = m_capture.open(m_deviceId);
+        success = openDevice();
     } else {
         success = m_capture.open(m_source);
     }
+    if (success) {
+        qDebug() << "Source open took" << (steadyNowNs() - openStartNs) / 1e6 << "ms";
+    }
 
     // 发送初始化结果信号
     emit opened(success);
@@ -85,88 +248,404 @@ void VideoProcessorWorker::start()
         return;
     }
 
+    // 实时源只保留最新的一两帧，避免驱动/解复用缓冲中积压过期画面；不支持的后端会忽略
+    if (m_isLiveStream && !m_capture.set(cv::CAP_PROP_BUFFERSIZE, 1)) {
+        qDebug() << "Capture backend ignores CAP_PROP_BUFFERSIZE";
+    }
+
+    // 源帧率与分辨率，帧率无效时调度器按 30fps
+    const double sourceFps = m_capture.get(cv::CAP_PROP_FPS);
+    const int frameCount = m_isLiveStream ? 0
+                                          : static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_COUNT));
+    m_pacer.reset(sourceFps, m_pacingMode);
+    emit sourceInfo(m_pacer.fps(), frameCount,
+                    static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+                    static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    qDebug() << "Source opened:" << sourceFps << "fps reported," << m_pacer.fps() << "fps used,"
+             << (m_isLiveStream ? "live" : (m_pacingMode == FramePacer::Mode::RealTime
+                                                ? "file (real-time)" : "file (every frame)"));
+
+    // 逐帧模式下采集队列不能丢帧
+    const QueuePolicy capturePolicy =
+        (!m_isLiveStream && m_pacingMode == FramePacer::Mode::EveryFrame) ? QueuePolicy::Block
+                                                                         : m_capturePolicy;
+
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    m_captureQueue = std::make_unique<BoundedQueue<CapturedFrame>>(m_queueCapacity, capturePolicy);
+    m_outputQueue = std::make_unique<BoundedQueue<InferredFrame>>(m_queueCapacity, m_outputPolicy);
+    m_captureCounter.reset();
+    m_inferenceCounter.reset();
+    m_modelCounter.reset();
+    m_fullFrameCounter.reset();
+    m_regionCounter.reset();
+    m_cascadeCounter.reset();
+    m_regionStreak = 0;
+    m_motionGate.setOptions(m_motionGateOptions);
+    m_motionGate.reset();
+    m_tracker.setOptions(m_trackerOptions);
+    m_tracker.reset();
+    m_outputCounter.reset();
+    m_decodedFrames.store(0, std::memory_order_relaxed);
+    m_skippedDecodes.store(0, std::memory_order_relaxed);
+    m_mailbox.reset();
+    FatigueOptions fatigueOptions = m_fatigueOptions;
+    fatigueOptions.minHits = m_trackerOptions.minHits;
+    m_fatigueMonitor.setOptions(fatigueOptions);
+    m_fatigueMonitor.setClassRoles(m_enginePool ? m_enginePool->classRoles() : ClassRoles());
+
+    // 源分辨率未知时先按显示尺寸建池，读到第一帧后按实际尺寸重建
+    cv::Size sourceSize(static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_WIDTH)),
+                        static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    if (sourceSize.area() <= 0) {
+        sourceSize = cv::Size(m_displayWidth, m_displayHeight);
+    }
+    m_capturePool = FramePool::create(sourceSize, m_rawYuyv ? CV_8UC2 : CV_8UC3, poolSize());
+    m_displayPool.reset();    // 由输出线程按实际帧尺寸创建
+
     m_running = true;
-    QTimer::singleShot(0, this, &VideoProcessorWorker::process);
+    m_captureThread = std::thread(&VideoProcessorWorker::captureLoop, this);
+    m_inferenceThread = std::thread(&VideoProcessorWorker::inferenceLoop, this);
+    m_outputThread = std::thread(&VideoProcessorWorker::outputLoop, this);
+}
+
+void VideoProcessorWorker::requestStop()
+{
+    // 不加锁：joinStages() 持有 m_stageMutex 等待线程退出
+    m_running = false;
 }
 
 void VideoProcessorWorker::stop()
 {
     m_running = false;
+    joinStages();
 }
 
-void VideoProcessorWorker::process()
+void VideoProcessorWorker::joinStages()
 {
-    if (!m_running || !m_capture.isOpened()) {
-        return;
-    }
+    std::lock_guard<std::mutex> lock(m_stageMutex);
 
-    cv::Mat frame;
-    if (!m_capture.read(frame)) {
-        // 视频结束或读取错误
-        if (!m_isDevice) {
-            // 对于视频文件，可能已到达结尾
-            stop();
-            return;
+    // 关闭队列唤醒阻塞在入队/出队上的线程
+    if (m_captureQueue) {
+        m_captureQueue->close();
+    }
+    if (m_outputQueue) {
+        m_outputQueue->close();
+    }
+    for (std::thread* t : {&m_captureThread, &m_inferenceThread, &m_outputThread}) {
+        if (t->joinable()) {
+            t->join();
         }
-        // 对于摄像头，尝试重新连接
-        emit error("帧读取失败");
+    }
+}
 
-        // 继续尝试
-        if (m_running) {
-            QTimer::singleShot(33, this, &VideoProcessorWorker::process);
+bool VideoProcessorWorker::openDevice()
+{
+    // 枚举设备模式并选出满足模型输入、每帧代价最低的一种；
+    // 无法枚举（非 V4L2 平台或设备）时按后端默认格式打开
+    if (m_negotiateFormat) {
+        CaptureRequirement requirement;
+        if (m_enginePool) {
+            const cv::Size modelSize = m_enginePool->inputSize();
+            requirement.modelWidth = modelSize.width;
+            requirement.modelHeight = modelSize.height;
+        }
+        requirement.minFps = m_minCaptureFps;
+
+        CaptureMode mode;
+        if (CaptureFormat::choose(CaptureFormat::probe(m_deviceId), requirement, mode)) {
+            qDebug() << "Capture format: chosen" << QString::fromStdString(CaptureFormat::fourccName(mode.fourcc))
+                     << mode.width << "x" << mode.height << "@" << mode.fps << "fps for model input"
+                     << requirement.modelWidth << "x" << requirement.modelHeight;
+            if (CaptureFormat::open(m_capture, m_deviceId, mode, true)) {
+                m_rawYuyv = CaptureFormat::deliversRawYuyv(m_capture);
+                return true;
+            }
+            qDebug() << "Capture format: negotiated open failed, falling back to defaults";
         }
-        return;
     }
+    return m_capture.open(m_deviceId);
+}
+
+size_t VideoProcessorWorker::poolSize() const
+{
+    // 两个队列各 capacity 帧，加上三个阶段、信箱和界面各持有一帧
+    return 2 * static_cast<size_t>(m_queueCapacity) + 5;
+}
 
-    if (frame.empty()) {
-        if (m_running) {
-            QTimer::singleShot(33, this, &VideoProcessorWorker::process);
+void VideoProcessorWorker::captureLoop()
+{
+    ThreadPlacement::apply(ThreadRole::Capture);
+    m_captureProbe.attach();
+    uint64_t frameId = 0;
+
+    while (m_running) {
+        const int64_t startNs = steadyNowNs();
+        m_captureProbe.sample();
+
+        // 先 grab() 取出压缩帧，确定要处理后才 retrieve() 解码；要丢弃的帧不解码
+        if (!m_capture.grab()) {
+            if (!m_isLiveStream) {
+                // 视频文件已到达结尾：下游处理完剩余帧后退出
+                m_running = false;
+                break;
+            }
+            // 对于摄像头，继续尝试
+            emit error("帧读取失败");
+            std::this_thread::sleep_for(std::chrono::milliseconds(33));
+            continue;
+        }
+
+        const uint64_t id = frameId++;
+        if (!shouldDecode()) {
+            m_skippedDecodes.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // 解码直接写入池中的缓冲区，尺寸一致时 retrieve() 不会重新分配
+        CapturedFrame captured;
+        captured.image = m_capturePool->acquire();
+        cv::Mat& image = captured.image.mat();
+        if (!m_capture.retrieve(image) || image.empty()) {
+            emit error("帧解码失败");
+            continue;
+        }
+        m_decodedFrames.fetch_add(1, std::memory_order_relaxed);
+
+        if (image.size() != m_capturePool->size() || image.type() != m_capturePool->type()) {
+            // 实际帧尺寸与池不符（源未报告分辨率或中途变化），按实际尺寸重建池
+            qDebug() << "Capture pool resized to" << image.cols << "x" << image.rows;
+            std::atomic_store(&m_capturePool, FramePool::create(image.size(), image.type(), poolSize()));
+        }
+
+        captured.id = id;
+
+        // 视频文件等到该帧的截止时刻再送出
+        if (!m_isLiveStream) {
+            m_pacer.waitUntilDue();
+        }
+
+        captured.captureNs = steadyNowNs();
+        m_captureCounter.add(captured.captureNs - startNs);
+
+        if (!m_captureQueue->push(std::move(captured))) {
+            break;
         }
-        return;
     }
 
-    // 在Worker线程中处理：Resize + 检测 + 绘制
-    cv::Mat displayFrame;
-    cv::resize(frame, displayFrame, cv::Size(m_displayWidth, m_displayHeight));
+    if (m_pacer.skippedFrames() > 0 || m_pacer.reanchorCount() > 0) {
+        qDebug() << "Pacer: skipped" << m_pacer.skippedFrames() << "frames, re-anchored"
+                 << m_pacer.reanchorCount() << "times";
+    }
 
-    // 如果启用检测且引擎可用
-    if (m_enableDetection && m_detectionEngine) {
-        auto results = m_detectionEngine->detect(displayFrame);
+    qDebug() << "Capture: decoded" << m_decodedFrames.load(std::memory_order_relaxed)
+             << "frames, skipped" << m_skippedDecodes.load(std::memory_order_relaxed)
+             << "without decoding";
+    m_captureQueue->close();
+}
 
-        // 绘制检测结果
-        for (const auto& det : results) {
-            cv::rectangle(displayFrame, det.bbox, cv::Scalar(0, 255, 0), 2);
+bool VideoProcessorWorker::shouldDecode()
+{
+    if (!m_isLiveStream) {
+        // 视频文件按帧时间戳调度：实时模式落后时该帧直接丢弃，逐帧模式总是解码
+        return m_pacer.schedule(m_capture.get(cv::CAP_PROP_POS_MSEC));
+    }
 
-            std::string label = det.className + " " +
-                                std::to_string(int(det.confidence * 100)) + "%";
-            cv::putText(displayFrame, label,
-                        cv::Point(det.bbox.x, det.bbox.y - 5),
-                        cv::FONT_HERSHEY_SIMPLEX, 0.5,
-                        cv::Scalar(0, 255, 0), 2);
+    // 实时流，丢弃最旧：推理还没取走上一帧时，解码出的帧只会在队列中变旧或把上一帧挤掉，
+    // 只 grab() 推进到最新；推理空出位置后解码的下一帧就是最新画面
+    const size_t queued = m_captureQueue->size();
+    if (m_captureQueue->policy() == QueuePolicy::DropOldest) {
+        return queued == 0;
+    }
+
+    // 阻塞：按配置的容量缓冲，队列满时不解码，避免 push() 阻塞采集线程而让设备缓冲区积压旧帧
+    return queued < static_cast<size_t>(std::max(1, m_queueCapacity));
+}
 
-            // 保存检测结果到数据库
-            if (m_dbManager && shouldSaveDetection(det.className, det.confidence)) {
-                m_dbManager->saveDetection(det.className, det.confidence);
+void VideoProcessorWorker::inferenceLoop()
+{
+    ThreadPlacement::apply(ThreadRole::Inference);
+    m_inferenceProbe.attach();
+
+    CapturedFrame captured;
+    while (m_captureQueue->pop(captured)) {
+        const int64_t startNs = steadyNowNs();
+        m_inferenceProbe.sample();
+
+        // 模型直接从源分辨率的帧做 letterbox，只重采样一次；显示缩放在输出阶段单独进行
+        InferredFrame inferred;
+        inferred.image = std::move(captured.image);
+        const cv::Mat& image = inferred.image.mat();
+
+        FrameResult& result = inferred.result;
+        result.frameId = captured.id;
+        result.captureNs = captured.captureNs;
+        result.imageWidth = image.cols;
+        result.imageHeight = image.rows;
+        result.count = 0;
+        result.reused = false;
+        result.inferred = false;
+
+        // 如果启用检测且引擎可用：只在跟踪器要求（到推理间隔或轨迹丢失）且画面有变化时推理，
+        // 其余帧由跟踪器预测检测框。加载了状态分类器时检测间隔拉长，
+        // 中间的每一帧都由分类器在人脸裁剪上判断状态。
+        // 门限只用于检测帧，参考帧也只在检测帧更新：若分类帧也推进参考帧，检测到期时
+        // 只和最近的分类帧比较，缓慢闭眼这类逐帧累积的变化会被判为静止而跳过检测
+        if (m_enableDetection && m_enginePool) {
+            const bool cascade = m_enginePool->supportsStateClassifier();
+            const bool due = m_tracker.detectionDue(image.size(), cascade);
+            if (due && m_motionGate.shouldInfer(image, captured.captureNs)) {
+                // 轨迹稳定时只推理人脸区域，每 reacquireInterval 次整帧推理一次以发现新目标
+                cv::Rect region;
+                const bool useRegion = m_trackerOptions.regionInference
+                                       && m_regionStreak < m_trackerOptions.reacquireInterval
+                                       && m_enginePool->supportsRegionInput()
+                                       && m_tracker.lockedRegion(region);
+
+                const int64_t modelStartNs = steadyNowNs();
+                DetectionEnginePool::Lease engine = m_enginePool->acquire();
+                result.assign(useRegion ? engine->detectRegion(image, region) : engine->detect(image));
+                const int64_t modelNs = steadyNowNs() - modelStartNs;
+                m_modelCounter.add(modelNs);
+                if (useRegion) {
+                    m_regionCounter.add(modelNs);
+                    ++m_regionStreak;
+                } else {
+                    m_fullFrameCounter.add(modelNs);
+                    m_regionStreak = 0;
+                }
+                m_tracker.update(result, captured.captureNs);
+                result.inferred = true;
+            } else {
+                m_tracker.predict(result, captured.captureNs);
+                result.reused = true;
+                if (cascade) {
+                    classifyTracks(image, result);
+                }
             }
         }
+        result.resultNs = steadyNowNs();
+
+        m_inferenceCounter.add(steadyNowNs() - startNs);
+        if (!m_outputQueue->push(std::move(inferred))) {
+            break;
+        }
     }
 
-    // 发送处理好的帧到主线程显示
-    emit frameReady(displayFrame);
+    m_outputQueue->close();
+}
 
-    // 继续处理下一帧
-    if (m_running) {
-        // 控制帧率，约30fps
-        QTimer::singleShot(33, this, &VideoProcessorWorker::process);
+void VideoProcessorWorker::classifyTracks(const cv::Mat& image, FrameResult& result)
+{
+    // 只判断确认且上次推理仍匹配到的轨迹，框为跟踪器预测到本帧的位置；
+    // 已丢失检测的轨迹框只是外推，裁出的区域不一定还是人脸
+    const int64_t startNs = steadyNowNs();
+    DetectionEnginePool::Lease engine = m_enginePool->acquire();
+    for (int i = 0; i < result.count; ++i) {
+        FrameDetection& detection = result.detections[i];
+        if (detection.trackHits < m_trackerOptions.minHits || detection.trackMisses > 0) {
+            continue;
+        }
+        float score = 0.0f;
+        const int classId = engine->classifyState(
+            image, cv::Rect2f(detection.x, detection.y, detection.width, detection.height), score);
+        if (classId >= 0) {
+            detection.classId = classId;
+            detection.score = score;
+            m_tracker.reclassify(detection.trackId, classId, score);
+        }
+    }
+    m_cascadeCounter.add(steadyNowNs() - startNs);
+}
+
+void VideoProcessorWorker::outputLoop()
+{
+    ThreadPlacement::apply(ThreadRole::Output);
+    m_outputProbe.attach();
+
+    InferredFrame inferred;
+    auto lastReport = std::chrono::steady_clock::now();
+
+    while (m_outputQueue->pop(inferred)) {
+        const int64_t startNs = steadyNowNs();
+        m_outputProbe.sample();
+        const FrameResult& result = inferred.result;
+
+        // 疲劳状态逐帧更新，只有等级切换写入数据库（类型为等级名，置信度列记 PERCLOS）；
+        // 画面保持原样，标注由界面在显示时绘制
+        if (m_fatigueMonitor.update(result)) {
+            const FatigueEvent& event = m_fatigueMonitor.lastEvent();
+            qDebug() << "Fatigue:" << fatigueLevelName(event.previous) << "->"
+                     << fatigueLevelName(event.level) << "| PERCLOS" << event.metrics.perclos
+                     << "yawns" << event.metrics.yawns << "longest closure"
+                     << event.metrics.longestClosureMs << "ms";
+            if (std::shared_ptr<DatabaseManager> dbManager = std::atomic_load(&m_dbManager)) {
+                dbManager->saveDetection(fatigueLevelName(event.level), event.metrics.perclos);
+            }
+            emit fatigueStateChanged(event);
+        }
+
+        emit resultReady(result);
+
+        // 缩小到显示尺寸后放入信箱，由界面按刷新节拍取走；界面卡顿时只保留最新一帧。
+        // 检测框仍是源分辨率坐标，由界面按 imageWidth/imageHeight 换算
+        // 原始 YUYV 帧在这里转成 BGR，颜色转换不占用推理线程
+        const cv::Mat& source = inferred.image.mat();
+        const bool yuyv = source.type() == CV_8UC2;
+        const cv::Size displaySize = fitDisplaySize(source.size(), m_displayWidth, m_displayHeight);
+        if (displaySize == source.size() && !yuyv) {
+            m_mailbox.post(inferred.image, result);
+        } else {
+            if (!m_displayPool || m_displayPool->size() != displaySize) {
+                std::atomic_store(&m_displayPool, FramePool::create(displaySize, CV_8UC3, poolSize()));
+            }
+            FrameHandle display = m_displayPool->acquire();
+            if (!yuyv) {
+                cv::resize(source, display.mat(), displaySize, 0, 0, cv::INTER_AREA);
+            } else if (displaySize == source.size()) {
+                cv::cvtColor(source, display.mat(), cv::COLOR_YUV2BGR_YUYV);
+            } else {
+                cv::cvtColor(source, m_displayConvert, cv::COLOR_YUV2BGR_YUYV);
+                cv::resize(m_displayConvert, display.mat(), displaySize, 0, 0, cv::INTER_AREA);
+            }
+            m_mailbox.post(display, result);
+        }
+        inferred.image.reset();
+        m_outputCounter.add(steadyNowNs() - startNs);
+
+        // 每 5 秒输出一次流水线统计
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(5)) {
+            lastReport = now;
+            const PipelineStats s = collectStats();
+            qDebug() << "Pipeline: capture" << s.captureMs << "ms, inference" << s.inferenceMs
+                     << "ms, output" << s.outputMs << "ms | queue depth"
+                     << s.captureQueueDepth << s.outputQueueDepth << "| dropped"
+                     << s.captureDropped << s.outputDropped << "| frames"
+                     << s.capturedFrames << s.inferredFrames << s.outputFrames
+                     << "| decoded" << s.decodedFrames << "skipped" << s.skippedDecodes
+                     << "| gate skipped" << s.gateSkipped << "/" << s.gateEvaluated
+                     << "saved ~" << (s.gateSkipped * s.modelMs - s.gateEvaluated * s.gateMs) << "ms"
+                     << "| predicted" << s.predictedFrames << "frames," << s.activeTracks << "tracks"
+                     << "| full" << s.fullFrames << "x" << s.fullFrameMs << "ms, region"
+                     << s.regionFrames << "x" << s.regionMs << "ms, classifier"
+                     << s.cascadeFrames << "x" << s.cascadeMs << "ms"
+                     << "| display" << s.displayedFrames << "shown" << s.displayDropped << "dropped"
+                     << "| pooled buffers" << s.pooledBuffers
+                     << "| migrations" << s.captureMigrations << s.inferenceMigrations
+                     << s.outputMigrations << "ui" << s.uiMigrations
+                     << "intra-op" << s.intraOpMigrations
+                     << "| latency" << (steadyNowNs() - result.captureNs) / 1e6 << "ms";
+        }
     }
 }
 
 // VideoProcessor 实现
 VideoProcessor::VideoProcessor(QObject* parent)
     : QObject(parent)
+    , m_displayTimer(new QTimer(this))
     , m_isRunning(false)
     , m_frameCount(0)
-    , m_fps(30.0)
+    , m_fps(0.0)
 {
     m_thread = std::make_unique<QThread>();
     m_worker = std::make_unique<VideoProcessorWorker>();
@@ -174,80 +653,31 @@ VideoProcessor::VideoProcessor(QObject* parent)
     // 将worker移动到线程
     m_worker->moveToThread(m_thread.get());
 
+    // 帧不再经排队信号逐个投递到界面线程，而是由界面定时从信箱取最新一帧，
+    // 界面忙时不会在事件队列里堆积帧
+    m_displayTimer->setTimerType(Qt::PreciseTimer);
+    m_displayTimer->setInterval(DEFAULT_DISPLAY_INTERVAL_MS);
+    connect(m_displayTimer, &QTimer::timeout, this, &VideoProcessor::pullLatestFrame);
+
     // 连接信号
-    connect(m_worker.get(), &VideoProcessorWorker::frameReady,
-            this, &VideoProcessor::frameReady);
+    qRegisterMetaType<FrameResult>();
+    qRegisterMetaType<FatigueEvent>();
+    connect(m_worker.get(), &VideoProcessorWorker::resultReady,
+            this, &VideoProcessor::resultReady);
+    connect(m_worker.get(), &VideoProcessorWorker::fatigueStateChanged,
+            this, &VideoProcessor::fatigueStateChanged);
     qDebug() << "Worker thread:" << m_worker->thread();
     qDebug() << "VideoProcessor thread:" << this->thread();
     connect(m_worker.get(), &VideoProcessorWorker::error,
             this, &VideoProcessor::error);
     connect(m_worker.get(), &VideoProcessorWorker::opened,
             this, &VideoProcessor::sourceOpened);
-
-    // connect(m_thread.get(), &QThread::started, [this]() {
-    //     HANDLE h = reinterpret_cast<HANDLE>(m_thread->currentThreadId());
-    //     SetThreadAffinityMask(h, 1ULL << 3);   // 核 3
-    // });
-
-    // connect(m_thread.get(), &QThread::started, [this]() {
-    //     HANDLE h = GetCurrentThread();   // 当前线程句柄（worker）
-
-    //     /* 1. 打印前 */
-    //     DWORD procBefore = GetCurrentProcessorNumber();
-    //     qDebug() << "worker thread"
-    //              << Qt::hex << reinterpret_cast<quintptr>(h)
-    //              << "currently on CPU" << procBefore;
-
-    //     /* 3. 绑核 */
-    //     SetThreadAffinityMask(h, 1ULL << 3);
-
-    //     /* 4. 打印后 */
-    //     DWORD procAfter = GetCurrentProcessorNumber();
-    //     qDebug() << "worker thread now bound to CPU" << procAfter;
-    // });
-
-    connect(m_thread.get(), &QThread::started, [this]() {
-        // ========== 验证1：当前线程ID ==========
-        qDebug() << "Lambda executing in thread:"
-                 << QThread::currentThread();
-        qDebug() << "Main thread:"
-                 << QCoreApplication::instance()->thread();
-        qDebug() << "Worker thread (m_thread):"
-                 << m_thread.get();
-
-        // 1. 当前线程“伪句柄” → 真实句柄
-        HANDLE pseudo = GetCurrentThread();   // 0xFFFFFFFE
-        HANDLE real   = nullptr;
-        DuplicateHandle(
-            GetCurrentProcess(),      // 源进程
-            pseudo,                   // 源句柄（伪）
-            GetCurrentProcess(),      // 目标进程
-            &real,                    // 输出：真实句柄
-            0, FALSE, DUPLICATE_SAME_ACCESS);
-
-
-        // ========== 验证2：GetCurrentThread() ==========
-        DWORD threadId = GetCurrentThreadId();
-        qDebug() << "Current Windows thread ID:" << threadId;
-        // 这个ID不是主线程的ID，而是子线程的ID ✅
-
-        // 2. 当前核
-        DWORD procBefore = GetCurrentProcessorNumber();
-        qDebug() << "worker real handle" << real
-                 << "currently on CPU" << procBefore;
-
-        // 3. 绑核
-        SetThreadAffinityMask(real, 1ULL << 3);
-
-        // 4. 立即再看
-        DWORD procAfter = GetCurrentProcessorNumber();
-        qDebug() << "worker now bound to CPU" << procAfter;
-
-        // 5. 用完关闭
-        CloseHandle(real);
-
-    });
-
+    connect(m_worker.get(), &VideoProcessorWorker::sourceInfo,
+            this, [this](double fps, int frameCount, int width, int height) {
+                m_fps = fps;
+                m_frameCount = frameCount;
+                m_frameSize = cv::Size(width, height);
+            });
 
     m_thread->start();
 }
@@ -257,6 +687,8 @@ VideoProcessor::~VideoProcessor()
     stop();
     m_thread->quit();
     m_thread->wait();
+    // 事件循环已退出，排队的 stop() 可能没有执行，在这里回收流水线线程
+    m_worker->stop();
 }
 
 bool VideoProcessor::openVideo(const std::string& filename)
@@ -265,7 +697,10 @@ bool VideoProcessor::openVideo(const std::string& filename)
         stop();
     }
 
-    m_worker->setSource(filename);
+    VideoProcessorWorker* worker = m_worker.get();
+    QMetaObject::invokeMethod(worker, [worker, filename]() {
+        worker->setSource(filename);
+    }, Qt::QueuedConnection);
 
     // 不再在主线程测试打开，改为直接返回 true
     // 实际的打开操作将在 Worker 线程的 start() 中异步执行
@@ -278,7 +713,10 @@ bool VideoProcessor::openCamera(int deviceId)
         stop();
     }
 
-    m_worker->setDevice(deviceId);
+    VideoProcessorWorker* worker = m_worker.get();
+    QMetaObject::invokeMethod(worker, [worker, deviceId]() {
+        worker->setDevice(deviceId);
+    }, Qt::QueuedConnection);
 
     // 不再在主线程测试打开，改为直接返回 true
     // 实际的打开操作将在 Worker 线程的 start() 中异步执行
@@ -291,7 +729,10 @@ bool VideoProcessor::openIPCamera(const std::string& url)
         stop();
     }
 
-    m_worker->setSource(url);
+    VideoProcessorWorker* worker = m_worker.get();
+    QMetaObject::invokeMethod(worker, [worker, url]() {
+        worker->setSource(url);
+    }, Qt::QueuedConnection);
 
     // 不再在主线程测试打开，改为直接返回 true
     // 实际的打开操作将在 Worker 线程的 start() 中异步执行
@@ -311,6 +752,7 @@ void VideoProcessor::start()
 
     m_isRunning = true;
     QMetaObject::invokeMethod(m_worker.get(), "start", Qt::QueuedConnection);
+    m_displayTimer->start();
 }
 
 void VideoProcessor::stop()
@@ -320,10 +762,28 @@ void VideoProcessor::stop()
     }
 
     m_isRunning = false;
-    m_worker->stop();
+    // 界面线程只发出停止通知；等待推理中的帧结束并回收线程放到 Worker 线程，
+    // 之后排队的 start() 也在它之后执行
+    m_worker->requestStop();
+    QMetaObject::invokeMethod(m_worker.get(), "stop", Qt::QueuedConnection);
+    m_displayTimer->stop();
     emit finished();
 }
 
+void VideoProcessor::setDisplayInterval(int intervalMs)
+{
+    m_displayTimer->setInterval(std::max(1, intervalMs));
+}
+
+void VideoProcessor::pullLatestFrame()
+{
+    FrameHandle frame;
+    FrameResult result;
+    if (m_worker->mailbox().take(frame, result)) {
+        emit frameReady(frame, result);
+    }
+}
+
 bool VideoProcessor::isRunning() const
 {
     return m_isRunning;
@@ -344,14 +804,14 @@ cv::Size VideoProcessor::getFrameSize() const
     return m_frameSize;
 }
 
-void VideoProcessor::setDetectionEngine(DetectionEngine* engine)
+void VideoProcessor::setEnginePool(DetectionEnginePool* pool)
 {
-    m_worker->setDetectionEngine(engine);
+    m_worker->setEnginePool(pool);
 }
 
-void VideoProcessor::setDatabaseManager(DatabaseManager* dbManager)
+void VideoProcessor::setDatabaseManager(std::shared_ptr<DatabaseManager> dbManager)
 {
-    m_worker->setDatabaseManager(dbManager);
+    m_worker->setDatabaseManager(std::move(dbManager));
 }
 
 void VideoProcessor::setDisplaySize(int width, int height)
@@ -364,42 +824,42 @@ void VideoProcessor::setEnableDetection(bool enable)
     m_worker->setEnableDetection(enable);
 }
 
-bool VideoProcessorWorker::shouldSaveDetection(const std::string& name, double confidence)
+void VideoProcessor::setQueuePolicies(QueuePolicy capturePolicy, QueuePolicy outputPolicy)
 {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    m_worker->setQueuePolicies(capturePolicy, outputPolicy);
+}
 
-    // 检查置信度阈值
-    if (confidence < m_confidenceThreshold) {
-        return false;
-    }
+void VideoProcessor::setQueueCapacity(int capacity)
+{
+    m_worker->setQueueCapacity(capacity);
+}
 
-    // 检查时间间隔
-    if (m_lastSaveTime.count(name) > 0) {
-        if (currentTime - m_lastSaveTime[name] < m_saveInterval) {
-            return false;
-        }
-    }
+void VideoProcessor::setPacingMode(FramePacer::Mode mode)
+{
+    m_worker->setPacingMode(mode);
+}
 
-    // 检查连续检测
-    if (m_lastDetection.count(name) > 0) {
-        double lastConf = m_lastDetection[name];
-        if (std::abs(confidence - lastConf) > 0.3) {
-            m_consecutiveCount[name] = 0;
-            return false;
-        }
+void VideoProcessor::setCaptureNegotiation(bool enabled, double minFps)
+{
+    m_worker->setCaptureNegotiation(enabled, minFps);
+}
 
-        m_consecutiveCount[name]++;
-        if (m_consecutiveCount[name] < 2) {
-            return false;
-        }
-    } else {
-        m_consecutiveCount[name] = 1;
-        m_lastDetection[name] = confidence;
-        return false;
-    }
+void VideoProcessor::setMotionGate(const MotionGateOptions& options)
+{
+    m_worker->setMotionGate(options);
+}
 
-    // 更新记录
-    m_lastDetection[name] = confidence;
-    m_lastSaveTime[name] = currentTime;
-    return true;
+void VideoProcessor::setTracker(const TrackerOptions& options)
+{
+    m_worker->setTracker(options);
+}
+
+void VideoProcessor::setFatigueMonitor(const FatigueOptions& options)
+{
+    m_worker->setFatigueMonitor(options);
+}
+
+PipelineStats VideoProcessor::pipelineStats() const
+{
+    return m_worker->stats();
 }
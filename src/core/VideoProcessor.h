@@ -3,13 +3,63 @@
 
 #include <QObject>
 #include <QThread>
+#include <QTimer>
 #include <opencv2/opencv.hpp>
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include "BoundedQueue.h"
+#include "FramePacer.h"
+#include "FrameMailbox.h"
+#include "FrameResult.h"
+#include "DetectionTracker.h"
+#include "FatigueMonitor.h"
+#include "MotionGate.h"
+#include "ThreadPlacement.h"
 
 // Forward declaration
-class DetectionEngine;
+class DetectionEnginePool;
 class DatabaseManager;
+struct CapturedFrame;
+struct InferredFrame;
+
+// 流水线统计：各级平均耗时（毫秒）、队列深度和丢帧数
+struct PipelineStats {
+    uint64_t capturedFrames = 0;
+    uint64_t decodedFrames = 0;     // grab() 后 retrieve() 解码的帧
+    uint64_t skippedDecodes = 0;    // 只 grab() 推进、未解码就丢弃的帧
+    uint64_t inferredFrames = 0;
+    uint64_t outputFrames = 0;
+    uint64_t captureDropped = 0;    // 采集→推理队列丢弃的帧
+    uint64_t outputDropped = 0;     // 推理→输出队列丢弃的帧
+    size_t captureQueueDepth = 0;
+    size_t outputQueueDepth = 0;
+    uint64_t displayedFrames = 0;
+    uint64_t displayDropped = 0;    // 界面来不及取走、在信箱中被覆盖的帧
+    uint64_t pooledBuffers = 0;     // 采集池和显示池累计创建的缓冲区，稳态下不再增长
+    uint64_t captureMigrations = 0; // 各级线程在 CPU 间的迁移次数
+    uint64_t inferenceMigrations = 0;
+    uint64_t outputMigrations = 0;
+    int64_t uiMigrations = -1;      // 界面线程和 ORT 算子线程按内核计数汇总，不可用时为 -1
+    int64_t intraOpMigrations = -1;
+    uint64_t gateEvaluated = 0;     // 经过变化门限判断的帧
+    uint64_t gateSkipped = 0;       // 画面静止、沿用上次结果而未推理的帧
+    double gateMs = 0.0;            // 门限判断的平均耗时
+    double modelMs = 0.0;           // 实际推理一帧的平均耗时（不含跳过的帧）
+    uint64_t fullFrames = 0;        // 整帧推理的帧
+    uint64_t regionFrames = 0;      // 只在人脸区域内推理的帧
+    double fullFrameMs = 0.0;       // 两种推理各自的平均耗时
+    double regionMs = 0.0;
+    uint64_t cascadeFrames = 0;     // 两次检测之间由状态分类器判断状态的帧
+    double cascadeMs = 0.0;         // 分类器一帧（所有轨迹）的平均耗时
+    uint64_t predictedFrames = 0;   // 未推理、由跟踪器预测检测框的帧（含门限跳过的帧）
+    int activeTracks = 0;
+    double captureMs = 0.0;
+    double inferenceMs = 0.0;
+    double outputMs = 0.0;
+};
 
 class VideoProcessorWorker : public QObject
 {
@@ -19,45 +69,128 @@ public:
     VideoProcessorWorker();
     ~VideoProcessorWorker();
 
+    // 在 Worker 线程中调用（排队），避免与尚未退出的流水线线程竞争
     void setSource(const std::string& source);
     void setDevice(int deviceId);
-    void setDetectionEngine(DetectionEngine* engine);
-    void setDatabaseManager(DatabaseManager* dbManager);
+    // 只通知各级退出，不等待；可在任意线程调用，随后排队调用 stop() 回收线程
+    void requestStop();
+    void setEnginePool(DetectionEnginePool* pool);
+    // 运行中可替换；输出线程持有引用期间旧实例不会被释放
+    void setDatabaseManager(std::shared_ptr<DatabaseManager> dbManager);
     void setDisplaySize(int width, int height);
     void setEnableDetection(bool enable);
+    // 流水线配置，下次 start() 生效。
+    // 实时流的采集队列按策略决定是否解码：丢弃最旧时只在队列为空时解码（容量不起作用），
+    // 阻塞时在队列未满前解码、满后只 grab() 跳过
+    void setQueuePolicies(QueuePolicy capturePolicy, QueuePolicy outputPolicy);
+    void setQueueCapacity(int capacity);
+    // 视频文件的帧调度方式；摄像头和网络流由设备自身节奏驱动
+    void setPacingMode(FramePacer::Mode mode);
+    // 本地摄像头按模型输入尺寸和最低帧率协商采集格式，关闭时使用后端默认格式
+    void setCaptureNegotiation(bool enabled, double minFps);
+    // 推理前的变化门限，下次 start() 生效
+    void setMotionGate(const MotionGateOptions& options);
+    // 检测跟踪与推理间隔，下次 start() 生效
+    void setTracker(const TrackerOptions& options);
+    // 疲劳判定阈值与窗口，下次 start() 生效
+    void setFatigueMonitor(const FatigueOptions& options);
+
+    PipelineStats stats() const;
+
+    // 输出线程写入、界面线程读取的最新帧
+    FrameMailbox& mailbox() { return m_mailbox; }
 
 signals:
-    void frameReady(const cv::Mat& frame);
     void error(const QString& message);
     void opened(bool success);  // 新增：初始化完成信号
+    // 打开成功后上报源信息：帧率、总帧数（实时流为 0）和分辨率
+    void sourceInfo(double fps, int frameCount, int width, int height);
+    // 每个推理完成的帧都发出，与显示无关，不会因界面丢帧而丢失
+    void resultReady(const FrameResult& result);
+    // 疲劳等级切换，已写入数据库
+    void fatigueStateChanged(const FatigueEvent& event);
 
 public slots:
-    void process();
     void start();
     void stop();
 
 private:
+    // 流水线各级：采集 → 推理 → 标注/输出，各在独立线程，由有界队列连接
+    void captureLoop();
+    void inferenceLoop();
+    void outputLoop();
+    void joinStages();
+    bool openDevice();                      // 打开本地摄像头，按需协商采集格式
+    bool shouldDecode();                    // 采集线程在 grab() 之后判断当前帧是否值得解码
+    void classifyTracks(const cv::Mat& image, FrameResult& result);  // 级联第二级，推理线程调用
+    PipelineStats collectStats() const;    // 不加锁，仅供流水线线程调用
+
     cv::VideoCapture m_capture;
     std::atomic<bool> m_running;
     std::string m_source;
     int m_deviceId;
     bool m_isDevice;
+    bool m_isLiveStream;        // 摄像头或网络流：read() 本身按源帧率阻塞，不需要调度
+    bool m_negotiateFormat;
+    double m_minCaptureFps;
+    bool m_rawYuyv;             // 采集帧为未转换的 YUYV（CV_8UC2），显示前由输出线程转成 BGR
+    FramePacer m_pacer;
+    FramePacer::Mode m_pacingMode;
+
+    std::unique_ptr<BoundedQueue<CapturedFrame>> m_captureQueue;
+    std::unique_ptr<BoundedQueue<InferredFrame>> m_outputQueue;
+    std::thread m_captureThread;
+    std::thread m_inferenceThread;
+    std::thread m_outputThread;
+    mutable std::mutex m_stageMutex;    // 保护队列和线程对象的创建与回收
+    QueuePolicy m_capturePolicy;
+    QueuePolicy m_outputPolicy;
+    int m_queueCapacity;
 
-    // 检测相关
-    DetectionEngine* m_detectionEngine;
-    DatabaseManager* m_dbManager;
+    // 各级累计耗时与帧数
+    struct StageCounter {
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> totalNs{0};
+        void add(int64_t ns);
+        double averageMs() const;
+        void reset();
+    };
+    StageCounter m_captureCounter;
+    StageCounter m_inferenceCounter;
+    StageCounter m_outputCounter;
+    StageCounter m_modelCounter;        // 只统计真正调用模型的帧
+    StageCounter m_fullFrameCounter;
+    StageCounter m_regionCounter;
+    StageCounter m_cascadeCounter;      // 级联第二级：状态分类器
+    int m_regionStreak;                 // 连续区域推理的次数，到 reacquireInterval 时整帧推理一次
+    MotionGate m_motionGate;            // 只在推理线程中使用
+    MotionGateOptions m_motionGateOptions;
+    DetectionTracker m_tracker;         // 只在推理线程中使用
+    TrackerOptions m_trackerOptions;
+    std::atomic<uint64_t> m_decodedFrames;
+    std::atomic<uint64_t> m_skippedDecodes;
+    ThreadPlacement::Probe m_captureProbe;
+    ThreadPlacement::Probe m_inferenceProbe;
+    ThreadPlacement::Probe m_outputProbe;
+    FrameMailbox m_mailbox;
+
+    // 帧缓冲池：采集池按源分辨率、显示池按保持宽高比的显示尺寸，每次 start() 重建。
+    // 采集池由采集线程、显示池由输出线程在尺寸变化时替换，其他线程通过 atomic_load 读取
+    std::shared_ptr<FramePool> m_capturePool;
+    std::shared_ptr<FramePool> m_displayPool;
+    cv::Mat m_displayConvert;   // 原始 YUYV 帧缩放显示前的 BGR 缓冲，输出线程复用
+    size_t poolSize() const;
+
+    // 检测相关：每帧从引擎池租用一个引擎
+    DetectionEnginePool* m_enginePool;
+    std::shared_ptr<DatabaseManager> m_dbManager;  // 数据库可能在运行中才就绪，只通过 atomic_load/atomic_store 访问
     int m_displayWidth;
     int m_displayHeight;
     bool m_enableDetection;
 
-    // 检测节流
-    std::map<std::string, double> m_lastDetection;
-    std::map<std::string, int> m_consecutiveCount;
-    std::map<std::string, qint64> m_lastSaveTime;
-    double m_confidenceThreshold;
-    int m_saveInterval;
-
-    bool shouldSaveDetection(const std::string& name, double confidence);
+    // 疲劳状态：只在输出线程中使用，状态切换才写数据库
+    FatigueMonitor m_fatigueMonitor;
+    FatigueOptions m_fatigueOptions;
 };
 
 class VideoProcessor : public QObject
@@ -76,10 +209,18 @@ public:
     void close();
 
     // 检测配置
-    void setDetectionEngine(DetectionEngine* engine);
-    void setDatabaseManager(DatabaseManager* dbManager);
+    void setEnginePool(DetectionEnginePool* pool);
+    void setDatabaseManager(std::shared_ptr<DatabaseManager> dbManager);
     void setDisplaySize(int width, int height);
     void setEnableDetection(bool enable);
+    void setQueuePolicies(QueuePolicy capturePolicy, QueuePolicy outputPolicy);
+    void setQueueCapacity(int capacity);
+    void setPacingMode(FramePacer::Mode mode);
+    void setCaptureNegotiation(bool enabled, double minFps);
+    void setMotionGate(const MotionGateOptions& options);
+    void setTracker(const TrackerOptions& options);
+    void setFatigueMonitor(const FatigueOptions& options);
+    PipelineStats pipelineStats() const;
 
 
 public slots:
@@ -88,26 +229,40 @@ public slots:
     void stop();
     bool isRunning() const;
 
+    // 界面刷新间隔（毫秒），按此节拍从信箱取最新帧
+    void setDisplayInterval(int intervalMs);
+
     // 获取视频信息
     int getFrameCount() const;
     double getFPS() const;
     cv::Size getFrameSize() const;
 
 signals:
-    void frameReady(const cv::Mat& frame);
+    // 待显示的最新帧（原始画面，未绘制标注）及其检测结果。
+    // 持有句柄即可保留该帧，缓冲区在所有句柄释放后才回到池中
+    void frameReady(const FrameHandle& frame, const FrameResult& result);
+    // 每帧的检测结果，供数据库、告警等不需要画面的消费者使用
+    void resultReady(const FrameResult& result);
+    void fatigueStateChanged(const FatigueEvent& event);
     void error(const QString& message);
     void finished();
     void sourceOpened(bool success);  // 新增：异步初始化完成信号
 
+private slots:
+    void pullLatestFrame();
+
 private:
     std::unique_ptr<QThread> m_thread;
     std::unique_ptr<VideoProcessorWorker> m_worker;
+    QTimer* m_displayTimer;
     bool m_isRunning;
 
     // 视频信息
     int m_frameCount;
     double m_fps;
     cv::Size m_frameSize;
+
+    static constexpr int DEFAULT_DISPLAY_INTERVAL_MS = 16;    // 约 60Hz
 };
 
 #endif // VIDEOPROCESSOR_H
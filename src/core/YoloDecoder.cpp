@@ -0,0 +1,146 @@
+#include "YoloDecoder.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cstddef>
+
+namespace {
+
+inline void emitBox(const float* output, int numAnchors, int anchor,
+                    float score, int classId, std::vector<DecodedBox>& candidates)
+{
+    const float cx = output[anchor];
+    const float cy = output[numAnchors + anchor];
+    const float w = output[2 * numAnchors + anchor];
+    const float h = output[3 * numAnchors + anchor];
+    candidates.push_back({cx - w * 0.5f, cy - h * 0.5f,
+                          cx + w * 0.5f, cy + h * 0.5f,
+                          score, classId});
+}
+
+} // namespace
+
+bool YoloDecoder::decode(const float* output, const std::vector<int64_t>& shape,
+                         float confThreshold, std::vector<DecodedBox>& candidates)
+{
+    candidates.clear();
+
+    if (output == nullptr || shape.size() != 3) {
+        return false;
+    }
+
+    // anchor 数远大于通道数，据此区分两种布局
+    const bool channelsFirst = shape[1] < shape[2];
+    const int numChannels = static_cast<int>(channelsFirst ? shape[1] : shape[2]);
+    const int numAnchors = static_cast<int>(channelsFirst ? shape[2] : shape[1]);
+    const int numClasses = numChannels - 4;
+    if (numClasses <= 0 || numAnchors <= 0) {
+        return false;
+    }
+
+    if (!channelsFirst) {
+        decodeChannelsLast(output, numClasses, numAnchors, confThreshold, candidates);
+        return true;
+    }
+
+    // 常见类别数在编译期展开类别循环
+    switch (numClasses) {
+    case 1:
+        decodeChannelsFirst<1>(output, numClasses, numAnchors, confThreshold, candidates);
+        break;
+    case 2:
+        decodeChannelsFirst<2>(output, numClasses, numAnchors, confThreshold, candidates);
+        break;
+    case 3:
+        decodeChannelsFirst<3>(output, numClasses, numAnchors, confThreshold, candidates);
+        break;
+    case 4:
+        decodeChannelsFirst<4>(output, numClasses, numAnchors, confThreshold, candidates);
+        break;
+    case 80:
+        decodeChannelsFirst<80>(output, numClasses, numAnchors, confThreshold, candidates);
+        break;
+    default:
+        decodeChannelsFirst<0>(output, numClasses, numAnchors, confThreshold, candidates);
+        break;
+    }
+    return true;
+}
+
+template <int NumClasses>
+void YoloDecoder::decodeChannelsFirst(const float* output, int numClasses, int numAnchors,
+                                      float confThreshold, std::vector<DecodedBox>& candidates)
+{
+    const int classes = NumClasses > 0 ? NumClasses : numClasses;
+    const float* scores = output + 4 * static_cast<size_t>(numAnchors);
+
+    int i = 0;
+#if CV_SIMD
+    // 按 SIMD 宽度并行做类别 argmax，整组低于阈值时直接跳过，不读取坐标
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 threshold = cv::vx_setall_f32(confThreshold);
+    float bestBuf[CV_SIMD_WIDTH / sizeof(float)];
+    float idBuf[CV_SIMD_WIDTH / sizeof(float)];
+
+    for (; i <= numAnchors - lanes; i += lanes) {
+        cv::v_float32 best = cv::vx_load(scores + i);
+        cv::v_float32 bestId = cv::vx_setzero_f32();
+        for (int c = 1; c < classes; ++c) {
+            cv::v_float32 s = cv::vx_load(scores + static_cast<size_t>(c) * numAnchors + i);
+            cv::v_float32 greater = cv::v_gt(s, best);
+            best = cv::v_select(greater, s, best);
+            bestId = cv::v_select(greater, cv::vx_setall_f32(static_cast<float>(c)), bestId);
+        }
+
+        const int mask = cv::v_signmask(cv::v_ge(best, threshold));
+        if (mask == 0) {
+            continue;
+        }
+
+        cv::v_store(bestBuf, best);
+        cv::v_store(idBuf, bestId);
+        for (int k = 0; k < lanes; ++k) {
+            if (mask & (1 << k)) {
+                emitBox(output, numAnchors, i + k, bestBuf[k],
+                        static_cast<int>(idBuf[k]), candidates);
+            }
+        }
+    }
+#endif
+
+    for (; i < numAnchors; ++i) {
+        float best = scores[i];
+        int bestId = 0;
+        for (int c = 1; c < classes; ++c) {
+            const float s = scores[static_cast<size_t>(c) * numAnchors + i];
+            if (s > best) {
+                best = s;
+                bestId = c;
+            }
+        }
+        if (best >= confThreshold) {
+            emitBox(output, numAnchors, i, best, bestId, candidates);
+        }
+    }
+}
+
+void YoloDecoder::decodeChannelsLast(const float* output, int numClasses, int numAnchors,
+                                     float confThreshold, std::vector<DecodedBox>& candidates)
+{
+    const int numChannels = numClasses + 4;
+    for (int i = 0; i < numAnchors; ++i) {
+        const float* row = output + static_cast<size_t>(i) * numChannels;
+        float best = row[4];
+        int bestId = 0;
+        for (int c = 1; c < numClasses; ++c) {
+            if (row[4 + c] > best) {
+                best = row[4 + c];
+                bestId = c;
+            }
+        }
+        if (best < confThreshold) {
+            continue;
+        }
+        candidates.push_back({row[0] - row[2] * 0.5f, row[1] - row[3] * 0.5f,
+                              row[0] + row[2] * 0.5f, row[1] + row[3] * 0.5f,
+                              best, bestId});
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef YOLODECODER_H
+#define YOLODECODER_H
+
+#include <cstdint>
+#include <vector>
+
+// 解码后的候选框：模型输入坐标系下的 x1y1x2y2
+struct DecodedBox {
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+    float score;
+    int classId;
+};
+
+// YOLOv8/v12 无 objectness 输出解码
+// 支持 [1, 4 + 类别数, anchor 数]（默认导出）和转置的 [1, anchor 数, 4 + 类别数]
+class YoloDecoder
+{
+public:
+    // 清空 candidates 后写入通过阈值的候选框，布局无法识别时返回 false
+    static bool decode(const float* output, const std::vector<int64_t>& shape,
+                       float confThreshold, std::vector<DecodedBox>& candidates);
+
+private:
+    template <int NumClasses>
+    static void decodeChannelsFirst(const float* output, int numClasses, int numAnchors,
+                                    float confThreshold, std::vector<DecodedBox>& candidates);
+    static void decodeChannelsLast(const float* output, int numClasses, int numAnchors,
+                                   float confThreshold, std::vector<DecodedBox>& candidates);
+};
+
+#endif // YOLODECODER_H
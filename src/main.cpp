@@ -1,4 +1,7 @@
 #include "mainwindow.h"
+#include "utils/Benchmark.h"
+#include "core/AppInitializer.h"
+#include "core/ThreadPlacement.h"
 
 #include <QApplication>
 #include <QDebug>
@@ -16,25 +19,40 @@
 //     qDebug() << "MainWindow shown";
 //     return a.exec();
 // }
-// ---------- Windows ----------
-#ifdef Q_OS_WIN
-#include <windows.h>
-static int currCpu() {
-    return static_cast<int>(GetCurrentProcessorNumber());
-}
-#endif
-
 int main(int argc, char *argv[])
 {
+    // 启动时间线的起点
+    AppInitializer::markProcessStart();
+
     QCoreApplication::setAttribute(Qt::AA_UseDesktopOpenGL);
 
     qDebug() << "Program started";
 
     // 打印启动瞬间所在核
-    qDebug() << "Main thread（启动时）on CPU" << currCpu();
+    qDebug() << "Main thread（启动时）on CPU" << ThreadPlacement::currentCpu();
 
     QApplication a(argc, argv);
+
+    // 基准测试模式：不启动界面，输出结果后退出
+    if (a.arguments().contains("--benchmark")) {
+        return Benchmark::run(a.arguments());
+    }
+    if (a.arguments().contains("--gate-replay")) {
+        return Benchmark::replayMotionGate(a.arguments());
+    }
+    if (a.arguments().contains("--fatigue-replay")) {
+        return Benchmark::replayFatigue(a.arguments());
+    }
+
     MainWindow w;
     w.show();
+
+    // 启动基准：--startup-benchmark [视频文件]，首次检测完成后输出时间线并退出
+    const QStringList args = a.arguments();
+    const int benchmarkIndex = args.indexOf("--startup-benchmark");
+    if (benchmarkIndex >= 0) {
+        w.runStartupBenchmark(benchmarkIndex + 1 < args.size() ? args[benchmarkIndex + 1]
+                                                               : QString());
+    }
     return a.exec();
 }
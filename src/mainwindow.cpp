@@ -1,6 +1,7 @@
 #include "mainwindow.h"
 #include "core/DatabaseManager.h"
-#include "core/DetectionEngine.h"
+#include "core/DetectionEnginePool.h"
+#include "core/ThreadPlacement.h"
 #include "core/VideoProcessor.h"
 #include "ui/SettingsDialog.h"
 #include "ui/DetectionRecordDialog.h"
@@ -14,61 +15,106 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QInputDialog>
-#include <QPixmap>
-#include <QImage>
 #include <QTimer>
 #include <QDateTime>
+#include <QApplication>
 #include <QDebug>
 #include <QCloseEvent>
-
-// mainwindow.cpp
-// #include <QTimer>
-// #ifdef Q_OS_LINUX
-// #include <sys/syscall.h>
-// static int cpuNow() { int c; syscall(SYS_getcpu,&c,nullptr,nullptr); return c; }
-// #endif
-// #ifdef Q_OS_WIN
-// #include <windows.h>
-// static int cpuNow() { return static_cast<int>(GetCurrentProcessorNumber()); }
-// #endif
+#include <QThread>
+#include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , m_showOverlays(true)
     , m_animationTimer(new QTimer(this))
     , m_rotationAngle(0)
     , m_lastFrameTime(0)
     , m_frameCount(0)
     , m_currentFPS(0.0)
+    , m_windowPaintRecorded(false)
+    , m_firstPaintRecorded(false)
+    , m_firstDetectionRecorded(false)
+    , m_startupBenchmark(false)
 {
     setWindowTitle("守护驶途");
     setMinimumSize(1200, 800);
 
-    // 初始化核心组件
+    m_initializer = std::make_unique<AppInitializer>();
+    connect(m_initializer.get(), &AppInitializer::componentStateChanged,
+            this, &MainWindow::updateComponentStatus);
+
+    // 初始化核心组件：这里只创建轻量对象，耗时的模型加载、数据库迁移和摄像头探测放到后台
     m_config = std::make_unique<Config>();
     loadConfig();
+    configureThreadPlacement();
+    m_initializer->milestone("config loaded");
 
-    m_dbManager = std::make_unique<DatabaseManager>(m_config->getDatabasePath());
-    qDebug() << "--------------";
-    m_detectionEngine = std::make_unique<DetectionEngine>();
-     qDebug() << "--------------";
+    m_enginePool = std::make_unique<DetectionEnginePool>(createEngineFactory(),
+                                                         m_config->getEnginePoolSize());
     m_videoProcessor = std::make_unique<VideoProcessor>();
+    m_classNames = m_enginePool->classNames();
+    m_showOverlays = m_config->getShowOverlays();
+    m_initializer->milestone("engine pool created");
 
-    // 加载模型
-    if (!m_currentModelPath.isEmpty()) {
-        m_detectionEngine->loadModel(m_currentModelPath.toStdString());
-        qDebug() << "loadModel returned"
-                 << m_detectionEngine->loadModel(m_currentModelPath.toStdString());
-    }
-
-    // 配置VideoProcessor
-    m_videoProcessor->setDetectionEngine(m_detectionEngine.get());
-    m_videoProcessor->setDatabaseManager(m_dbManager.get());
+    // 配置VideoProcessor（数据库就绪后再设置）
+    m_videoProcessor->setEnginePool(m_enginePool.get());
     m_videoProcessor->setDisplaySize(DISPLAY_WIDTH, DISPLAY_HEIGHT);
     m_videoProcessor->setEnableDetection(true);
+    auto queuePolicy = [](const std::string& name) {
+        return name == "block" ? QueuePolicy::Block : QueuePolicy::DropOldest;
+    };
+    m_videoProcessor->setQueuePolicies(queuePolicy(m_config->getCaptureQueuePolicy()),
+                                       queuePolicy(m_config->getOutputQueuePolicy()));
+    m_videoProcessor->setQueueCapacity(m_config->getPipelineQueueCapacity());
+    m_videoProcessor->setPacingMode(m_config->getFilePacingMode() == "realtime"
+                                        ? FramePacer::Mode::RealTime
+                                        : FramePacer::Mode::EveryFrame);
+    m_videoProcessor->setCaptureNegotiation(m_config->getCameraNegotiateFormat(),
+                                            m_config->getCameraMinFps());
+    MotionGateOptions gateOptions;
+    gateOptions.enabled = m_config->getMotionGateEnabled();
+    gateOptions.threshold = m_config->getMotionGateThreshold();
+    gateOptions.refreshIntervalMs = m_config->getMotionGateRefreshMs();
+    m_videoProcessor->setMotionGate(gateOptions);
+    TrackerOptions trackerOptions;
+    trackerOptions.detectInterval = std::max(1, m_config->getTrackerDetectInterval());
+    trackerOptions.regionInference = m_config->getRoiEnabled();
+    trackerOptions.regionPadding = static_cast<float>(m_config->getRoiPadding());
+    trackerOptions.reacquireInterval = std::max(1, m_config->getRoiReacquireInterval());
+    trackerOptions.cascadeDetectInterval = std::max(1, m_config->getCascadeDetectInterval());
+    m_videoProcessor->setTracker(trackerOptions);
+    FatigueOptions fatigueOptions;
+    fatigueOptions.drowsyPerclos = m_config->getFatigueDrowsyPerclos();
+    fatigueOptions.criticalPerclos = m_config->getFatigueCriticalPerclos();
+    fatigueOptions.drowsyYawns = m_config->getFatigueDrowsyYawns();
+    fatigueOptions.criticalYawns = m_config->getFatigueCriticalYawns();
+    fatigueOptions.drowsyClosureMs = m_config->getFatigueDrowsyClosureMs();
+    fatigueOptions.criticalClosureMs = m_config->getFatigueCriticalClosureMs();
+    fatigueOptions.recoveryMs = m_config->getFatigueRecoveryMs();
+    fatigueOptions.perclosWindowMs = m_config->getFatiguePerclosWindowMs();
+    fatigueOptions.yawnWindowMs = m_config->getFatigueYawnWindowMs();
+    fatigueOptions.minHits = trackerOptions.minHits;
+    // 界面文字按修正后的窗口显示，与疲劳判定实际使用的一致
+    m_fatigueOptions = FatigueMonitor::validated(fatigueOptions);
+    m_videoProcessor->setFatigueMonitor(m_fatigueOptions);
+    // 区域输入在模型加载时绑定，必须在 startInitialization() 之前设置
+    m_enginePool->setRegionInput(m_config->getRoiEnabled() ? m_config->getRoiInputSize() : 0,
+                                 m_config->getRoiModelPath());
+    m_enginePool->setStateClassifiers(m_config->getCascadeEyeModelPath(),
+                                      m_config->getCascadeMouthModelPath());
+    ClassRoles classRoles = m_enginePool->classRoles();
+    classRoles.eyesClosed = m_config->getFatigueEyesClosedClass();
+    classRoles.yawn = m_config->getFatigueYawnClass();
+    m_enginePool->setClassRoles(classRoles);
 
     // 设置UI
     setupUI();
     setupConnections();
+    m_initializer->milestone("ui built");
+
+    startInitialization();
+    // 界面线程的放置放在其他线程创建之后：新线程继承创建者的亲和性和调度参数
+    ThreadPlacement::apply(ThreadRole::Ui);
 
     // 设置性能监测定时器 (每50ms更新一次动画，20fps)
     m_animationTimer->setInterval(50);
@@ -85,6 +131,8 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // 后台初始化任务引用引擎池，需先结束
+    m_initializer->waitForFinished();
     stopCamera();
     stopIPCamera();
     stopVideoDetection();
@@ -207,6 +255,18 @@ void MainWindow::createLeftPanel()
     ipcameraLayout->addWidget(m_ipcameraStopBtn);
     layout->addWidget(ipcameraGroup);
 
+    // 系统状态组：各组件初始化进度
+    auto* statusGroup = new QGroupBox("系统状态", m_leftPanel);
+    auto* statusLayout = new QVBoxLayout(statusGroup);
+    m_modelStatusLabel = new QLabel("模型：加载中...", statusGroup);
+    m_databaseStatusLabel = new QLabel("数据库：初始化中...", statusGroup);
+    m_cameraStatusLabel = new QLabel("摄像头：检测中...", statusGroup);
+
+    statusLayout->addWidget(m_modelStatusLabel);
+    statusLayout->addWidget(m_databaseStatusLabel);
+    statusLayout->addWidget(m_cameraStatusLabel);
+    layout->addWidget(statusGroup);
+
     // 性能监测组
     auto* performanceGroup = new QGroupBox("性能监测", m_leftPanel);
     auto* performanceLayout = new QVBoxLayout(performanceGroup);
@@ -256,21 +316,14 @@ void MainWindow::createRightPanel()
     layout->addWidget(title);
 
     // 图像显示区域
-    m_imageLabel = new QLabel(m_rightPanel);
-    m_imageLabel->setFixedSize(DISPLAY_WIDTH, DISPLAY_HEIGHT);
-    m_imageLabel->setStyleSheet(R"(
-        QLabel {
-            border: 2px solid #BDC3C7;
-            background-color: #ECF0F1;
-        }
-    )");
-    m_imageLabel->setAlignment(Qt::AlignCenter);
-    m_imageLabel->setText("等待检测...");
+    m_videoView = new VideoView(m_rightPanel);
+    m_videoView->setFixedSize(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    m_videoView->setPlaceholderText("等待检测...");
 
-    // 创建容器居中显示图像标签
+    // 创建容器居中显示图像
     auto* imageContainer = new QWidget(m_rightPanel);
     auto* imageContainerLayout = new QHBoxLayout(imageContainer);
-    imageContainerLayout->addWidget(m_imageLabel);
+    imageContainerLayout->addWidget(m_videoView);
     imageContainerLayout->setAlignment(Qt::AlignCenter);
     layout->addWidget(imageContainer);
 
@@ -345,31 +398,79 @@ void MainWindow::createSettingsButton()
 
 void MainWindow::setupConnections()
 {
+    // 启动类操作按依赖排队：初始化未完成时点击不会阻塞 UI，就绪后自动执行
+    const AppInitializer::Components model = AppInitializer::Model;
+
     // 图片检测
     connect(m_imageSelectBtn, &QPushButton::clicked, this, &MainWindow::selectImage);
-    connect(m_imageStartBtn, &QPushButton::clicked, this, &MainWindow::startImageDetection);
-    connect(m_imageStopBtn, &QPushButton::clicked, this, &MainWindow::stopImageDetection);
+    connect(m_imageStartBtn, &QPushButton::clicked, this, [this, model]() {
+        runWhenReady(model, "图片检测", &MainWindow::startImageDetection);
+    });
+    connect(m_imageStopBtn, &QPushButton::clicked, this, [this]() {
+        m_initializer->cancel("图片检测");
+        stopImageDetection();
+    });
 
     // 视频检测
     connect(m_videoSelectBtn, &QPushButton::clicked, this, &MainWindow::selectVideo);
-    connect(m_videoStartBtn, &QPushButton::clicked, this, &MainWindow::startVideoDetection);
-    connect(m_videoStopBtn, &QPushButton::clicked, this, &MainWindow::stopVideoDetection);
-
-    // 实时视频
-    connect(m_cameraStartBtn, &QPushButton::clicked, this, &MainWindow::startCamera);
-    connect(m_cameraStopBtn, &QPushButton::clicked, this, &MainWindow::stopCamera);
+    connect(m_videoStartBtn, &QPushButton::clicked, this, [this, model]() {
+        runWhenReady(model, "视频检测", &MainWindow::startVideoDetection);
+    });
+    connect(m_videoStopBtn, &QPushButton::clicked, this, [this]() {
+        m_initializer->cancel("视频检测");
+        stopVideoDetection();
+    });
+
+    // 实时视频：还需等待摄像头探测结束，避免与探测同时打开设备
+    connect(m_cameraStartBtn, &QPushButton::clicked, this, [this, model]() {
+        runWhenReady(model | AppInitializer::Camera, "摄像头检测", &MainWindow::startCamera);
+    });
+    connect(m_cameraStopBtn, &QPushButton::clicked, this, [this]() {
+        m_initializer->cancel("摄像头检测");
+        stopCamera();
+    });
 
     // 网络摄像头
-    connect(m_ipcameraStartBtn, &QPushButton::clicked, this, &MainWindow::startIPCamera);
-    connect(m_ipcameraStopBtn, &QPushButton::clicked, this, &MainWindow::stopIPCamera);
+    connect(m_ipcameraStartBtn, &QPushButton::clicked, this, [this, model]() {
+        runWhenReady(model, "网络摄像头", &MainWindow::startIPCamera);
+    });
+    connect(m_ipcameraStopBtn, &QPushButton::clicked, this, [this]() {
+        m_initializer->cancel("网络摄像头");
+        stopIPCamera();
+    });
 
-    // 设置和记录
-    connect(m_settingsBtn, &QPushButton::clicked, this, &MainWindow::showSettings);
-    connect(m_recordBtn, &QPushButton::clicked, this, &MainWindow::showRecords);
+    // 设置：模型加载结束后打开（加载失败时也允许打开以重新选择模型）
+    connect(m_settingsBtn, &QPushButton::clicked, this, [this, model]() {
+        m_initializer->whenReady(model, "设置", [this]() { showSettings(); },
+                                 [this](AppInitializer::Component) { showSettings(); });
+    });
+    connect(m_recordBtn, &QPushButton::clicked, this, [this]() {
+        runWhenReady(AppInitializer::Database, "检测记录", &MainWindow::showRecords);
+    });
 
     // 视频处理器信号
     connect(m_videoProcessor.get(), &VideoProcessor::frameReady,
             this, &MainWindow::onFrameReady);
+
+    // 启动时间线：画面控件真正绘制出一帧、模型真正给出一次结果时记录，各只记录一次
+    m_firstPaintConnection = connect(m_videoView, &VideoView::framePainted, this, [this]() {
+        disconnect(m_firstPaintConnection);
+        m_firstPaintRecorded = true;
+        m_initializer->milestone("first frame painted");
+        finishStartupTimeline();
+    });
+    m_firstDetectionConnection = connect(m_videoProcessor.get(), &VideoProcessor::resultReady,
+                                         this, [this](const FrameResult& result) {
+        if (!result.inferred) {
+            return;
+        }
+        disconnect(m_firstDetectionConnection);
+        m_firstDetectionRecorded = true;
+        m_initializer->milestone("first detection");
+        finishStartupTimeline();
+    });
+    connect(m_videoProcessor.get(), &VideoProcessor::fatigueStateChanged,
+            this, &MainWindow::onFatigueStateChanged);
     connect(m_videoProcessor.get(), &VideoProcessor::sourceOpened,
             this, &MainWindow::onSourceOpened);
     connect(m_videoProcessor.get(), &VideoProcessor::error,
@@ -382,6 +483,127 @@ void MainWindow::loadConfig()
     m_currentModelPath = QString::fromStdString(m_config->getModelPath());
 }
 
+void MainWindow::configureThreadPlacement()
+{
+    // 各角色的策略在对应线程启动时生效；界面线程在构造末尾、后台线程启动后应用
+    for (ThreadRole role : {ThreadRole::Ui, ThreadRole::Capture, ThreadRole::Inference,
+                            ThreadRole::IntraOp, ThreadRole::Output, ThreadRole::Background}) {
+        const std::string name = ThreadPlacement::roleName(role);
+        ThreadPlacementPolicy policy;
+        policy.cpus = ThreadPlacementPolicy::parseCpuList(m_config->getThreadCpus(name));
+        policy.scheduler = m_config->getThreadScheduler(name);
+        policy.priority = m_config->getThreadPriority(name);
+        ThreadPlacement::configure(role, policy);
+    }
+}
+
+std::shared_ptr<EngineFactory> MainWindow::createEngineFactory() const
+{
+    const int poolSize = std::max(1, m_config->getEnginePoolSize());
+
+    EngineFactoryOptions options;
+    options.globalThreadPool = m_config->getGlobalThreadPool();
+    options.arenaExtendStrategy = m_config->getArenaExtendStrategy();
+    options.arenaMemoryLimitMB = m_config->getArenaMemoryLimitMB();
+    options.cacheOptimizedModel = m_config->getOptimizedModelCache();
+    // 界面线程有放置策略时，之后（如模型热替换）创建的算子线程会继承它，同样由本程序创建以便恢复
+    options.placeIntraOpThreads = ThreadPlacement::isConfigured(ThreadRole::IntraOp)
+                                  || ThreadPlacement::isConfigured(ThreadRole::Ui);
+
+    // 线程划分：每会话线程数 × 会话数；全局线程池时合并为一个池
+    int intraOpThreads = m_config->getIntraOpThreads();
+    if (intraOpThreads <= 0) {
+        const int cores = std::max(1, QThread::idealThreadCount());
+        intraOpThreads = std::max(1, cores / poolSize);
+    }
+    options.intraOpThreads = options.globalThreadPool ? intraOpThreads * poolSize
+                                                      : intraOpThreads;
+
+    return std::make_shared<EngineFactory>(options);
+}
+
+void MainWindow::startInitialization()
+{
+    DetectionEnginePool* pool = m_enginePool.get();
+    const std::string modelPath = m_currentModelPath.toStdString();
+    const std::string dbPath = m_config->getDatabasePath();
+
+    m_initializer->addTask(AppInitializer::Model, [pool, modelPath]() {
+        return !modelPath.empty() && pool->loadModel(modelPath);
+    });
+    m_initializer->addTask(AppInitializer::Database, [dbPath]() {
+        return DatabaseManager::migrate(dbPath);
+    });
+    m_initializer->addTask(AppInitializer::Camera, []() {
+        // 只探测设备是否可用，真正打开由视频线程负责；同时提前加载采集后端
+        cv::VideoCapture capture;
+        bool available = capture.open(0);
+        capture.release();
+        return available;
+    });
+    m_initializer->start();
+}
+
+void MainWindow::updateComponentStatus(AppInitializer::Component component,
+                                       AppInitializer::State state, qint64 elapsedMs)
+{
+    const bool ready = state == AppInitializer::State::Ready;
+    const QString cost = QString(" (%1 ms)").arg(elapsedMs);
+
+    switch (component) {
+    case AppInitializer::Model:
+        m_modelStatusLabel->setText(ready ? "模型：就绪" + cost : "模型：加载失败");
+        break;
+    case AppInitializer::Database:
+        // 迁移已在后台完成，这里在主线程打开连接；先于排队操作执行
+        if (ready && !m_dbManager) {
+            m_dbManager = std::make_shared<DatabaseManager>(m_config->getDatabasePath());
+            m_videoProcessor->setDatabaseManager(m_dbManager);
+        }
+        m_databaseStatusLabel->setText(ready ? "数据库：就绪" + cost : "数据库：初始化失败");
+        break;
+    case AppInitializer::Camera:
+        m_cameraStatusLabel->setText(ready ? "摄像头：可用" + cost : "摄像头：未检测到");
+        break;
+    }
+}
+
+void MainWindow::runWhenReady(AppInitializer::Components dependencies, const QString& name,
+                              void (MainWindow::*action)())
+{
+    if (!m_initializer->isReady(dependencies)) {
+        updateDetectionResult(QString("正在初始化，完成后将自动开始%1...").arg(name));
+    }
+
+    m_initializer->whenReady(dependencies, name, [this, action]() { (this->*action)(); },
+        [this, name, action](AppInitializer::Component failed) {
+            // 摄像头探测失败时仍尝试打开（设备可能稍后接入），结果由 sourceOpened 报告
+            if (failed == AppInitializer::Camera
+                && m_initializer->isReady(AppInitializer::Model)) {
+                (this->*action)();
+                return;
+            }
+            QMessageBox::warning(this, "错误",
+                                 QString("%1初始化失败，无法执行%2")
+                                     .arg(failed == AppInitializer::Model ? "模型"
+                                          : failed == AppInitializer::Database ? "数据库"
+                                                                               : "摄像头",
+                                          name));
+        });
+}
+
+void MainWindow::runStartupBenchmark(const QString& source)
+{
+    m_startupBenchmark = true;
+    if (source.isEmpty()) {
+        runWhenReady(AppInitializer::Model | AppInitializer::Camera, "摄像头检测",
+                     &MainWindow::startCamera);
+    } else {
+        m_currentVideoPath = source;
+        runWhenReady(AppInitializer::Model, "视频检测", &MainWindow::startVideoDetection);
+    }
+}
+
 void MainWindow::saveConfig()
 {
     m_config->setModelPath(m_currentModelPath.toStdString());
@@ -402,13 +624,10 @@ void MainWindow::selectImage()
         m_imagepathLabel->setText(QFileInfo(fileName).fileName());
 
         // 显示选择的图片
-        QPixmap pixmap(fileName);
-        QPixmap scaled = pixmap.scaled(
-            m_imageLabel->size(),
-            Qt::KeepAspectRatio,
-            Qt::SmoothTransformation
-            );
-        m_imageLabel->setPixmap(scaled);
+        cv::Mat preview = cv::imread(fileName.toStdString());
+        if (!preview.empty()) {
+            m_videoView->setFrame(preview);
+        }
     }
 }
 
@@ -425,35 +644,35 @@ void MainWindow::startImageDetection()
         return;
     }
 
-    // 调整图像大小
-    cv::resize(image, image, cv::Size(DISPLAY_WIDTH, DISPLAY_HEIGHT));
-
-    // 执行检测
-    auto results = m_detectionEngine->detect(image);
-
-    // 绘制检测结果
-    for (const auto& det : results) {
-        cv::rectangle(image, det.bbox, cv::Scalar(0, 255, 0), 2);
-        std::string label = det.className + " " +
-                            std::to_string(int(det.confidence * 100)) + "%";
-        cv::putText(image, label,
-                    cv::Point(det.bbox.x, det.bbox.y - 5),
-                    cv::FONT_HERSHEY_SIMPLEX, 0.5,
-                    cv::Scalar(0, 255, 0), 2);
+    // 执行检测：直接用原图，模型输入只做一次 letterbox，显示缩放交给 VideoView；
+    // 与视频线程各自租用引擎，互不竞争
+    std::vector<Detection> results;
+    {
+        DetectionEnginePool::Lease engine = m_enginePool->acquire();
+        results = engine->detect(image);
+    }
 
-        // 保存检测结果（图片检测直接保存）
-        m_dbManager->saveDetection(det.className, det.confidence);
+    // 保存检测结果（图片检测直接保存）
+    if (m_dbManager) {
+        for (const auto& det : results) {
+            m_dbManager->saveDetection(det.className, det.confidence);
+        }
     }
 
-    // 显示结果
-    onFrameReady(image);
+    // 显示结果：与视频相同，标注在显示时绘制
+    FrameResult frameResult{};
+    frameResult.imageWidth = image.cols;
+    frameResult.imageHeight = image.rows;
+    frameResult.assign(results);
+    frameResult.inferred = true;
+    m_videoView->setFrame(image);
+    m_videoView->setOverlays(overlaysFor(frameResult), QSize(image.cols, image.rows));
     updateDetectionResult(QString("检测完成：发现 %1 个目标").arg(results.size()));
 }
 
 void MainWindow::stopImageDetection()
 {
-    m_imageLabel->clear();
-    m_imageLabel->setText("等待检测...");
+    m_videoView->clear();
     updateDetectionResult("检测已停止");
 }
 
@@ -567,19 +786,32 @@ void MainWindow::showSettings()
         QString newDbPath = dialog.getDatabasePath();
 
         if (!newModelPath.isEmpty() && newModelPath != m_currentModelPath) {
-            if (m_detectionEngine->loadModel(newModelPath.toStdString())) {
-                qDebug() << "loadModel returned"
-                         << m_detectionEngine->loadModel(m_currentModelPath.toStdString());
-                m_currentModelPath = newModelPath;
-                QMessageBox::information(this, "成功", "模型已更新");
-            } else {
-                QMessageBox::warning(this, "错误", "加载模型失败");
-            }
+            // 热替换：新模型在后台加载预热，完成后在两帧之间切换，检测不中断
+            m_modelStatusLabel->setText("模型：切换中...");
+            DetectionEnginePool* pool = m_enginePool.get();
+            const std::string modelPath = newModelPath.toStdString();
+            m_initializer->runInBackground(
+                [pool, modelPath]() { return pool->loadModel(modelPath); },
+                [this, newModelPath](bool success) {
+                    if (success) {
+                        m_currentModelPath = newModelPath;
+                        saveConfig();
+                        m_initializer->setState(AppInitializer::Model, AppInitializer::State::Ready);
+                        updateDetectionResult("模型已更新");
+                    } else {
+                        m_modelStatusLabel->setText(m_enginePool->isModelLoaded()
+                                                        ? "模型：就绪（切换失败）"
+                                                        : "模型：加载失败");
+                        QMessageBox::warning(this, "错误", "加载模型失败，继续使用当前模型");
+                    }
+                });
         }
 
         if (newDbPath != QString::fromStdString(m_config->getDatabasePath())) {
             m_config->setDatabasePath(newDbPath.toStdString());
-            m_dbManager = std::make_unique<DatabaseManager>(newDbPath.toStdString());
+            // 输出线程可能正在使用旧实例，它持有的引用释放后旧实例才析构
+            m_dbManager = std::make_shared<DatabaseManager>(newDbPath.toStdString());
+            m_videoProcessor->setDatabaseManager(m_dbManager);
         }
 
         saveConfig();
@@ -592,35 +824,43 @@ void MainWindow::showRecords()
     dialog.exec();
 }
 
-void MainWindow::onFrameReady(const cv::Mat& frame)
+void MainWindow::onFrameReady(const FrameHandle& frame, const FrameResult& result)
 {
-    if (frame.empty()) {
+    if (frame.empty() || frame.mat().empty()) {
         return;
     }
 
-    // Worker已经完成了检测和绘制，这里只需要显示
-    cv::Mat rgb;
-    if (frame.channels() == 3) {
-        cv::cvtColor(frame, rgb, cv::COLOR_BGR2RGB);
-    } else {
-        rgb = frame;
-    }
-
-    // 创建QImage并复制数据
-    QImage qImg(rgb.data, rgb.cols, rgb.rows, rgb.step,
-                rgb.channels() == 3 ? QImage::Format_RGB888 : QImage::Format_Grayscale8);
-    QImage qImgCopy = qImg.copy();
+    // Worker已经完成了检测，这里只需要显示：控件持有句柄并直接绘制 BGR 缓冲区，标注另行绘制
+    m_videoView->setFrame(frame.mat(), frame);
+    m_videoView->setOverlays(overlaysFor(result), QSize(result.imageWidth, result.imageHeight));
+}
 
-    // 显示到QLabel
-    QPixmap pixmap = QPixmap::fromImage(qImgCopy);
-    QPixmap scaledPixmap = pixmap.scaled(m_imageLabel->size(),
-                                         Qt::KeepAspectRatio,
-                                         Qt::SmoothTransformation);
-    m_imageLabel->setPixmap(scaledPixmap);
+std::vector<VideoOverlay> MainWindow::overlaysFor(const FrameResult& result) const
+{
+    std::vector<VideoOverlay> overlays;
+    if (!m_showOverlays) {
+        return overlays;
+    }
 
-    if (!m_imageLabel->text().isEmpty()) {
-        m_imageLabel->setText("");
+    overlays.reserve(result.count);
+    for (int i = 0; i < result.count; ++i) {
+        const FrameDetection& det = result.detections[i];
+        const QString name = (det.classId >= 0 && det.classId < static_cast<int>(m_classNames.size()))
+                                 ? QString::fromStdString(m_classNames[det.classId])
+                                 : QString("unknown");
+        QString label = QString("%1 %2%").arg(name).arg(int(det.score * 100));
+        if (det.trackId >= 0) {
+            label = QString("#%1 %2").arg(det.trackId).arg(label);
+        }
+        // 已丢失检测、仅靠外推保留的轨迹：类别是丢失前的，用灰色并标出以免误读
+        const bool coasting = det.trackMisses > 0;
+        if (coasting) {
+            label += " (lost)";
+        }
+        overlays.push_back({QRectF(det.x, det.y, det.width, det.height), label,
+                            coasting ? QColor(160, 160, 160) : QColor(0, 255, 0)});
     }
+    return overlays;
 }
 
 
@@ -640,6 +880,27 @@ void MainWindow::resizeEvent(QResizeEvent* event)
     }
 }
 
+void MainWindow::paintEvent(QPaintEvent* event)
+{
+    QMainWindow::paintEvent(event);
+    if (!m_windowPaintRecorded) {
+        m_windowPaintRecorded = true;
+        m_initializer->milestone("window painted");
+    }
+}
+
+void MainWindow::finishStartupTimeline()
+{
+    // 第一帧画面已绘制且第一个推理结果已到达
+    if (!m_firstPaintRecorded || !m_firstDetectionRecorded) {
+        return;
+    }
+    m_initializer->reportMilestones();
+    if (m_startupBenchmark) {
+        QTimer::singleShot(0, qApp, &QCoreApplication::quit);
+    }
+}
+
 void MainWindow::closeEvent(QCloseEvent* event)
 {
     stopCamera();
@@ -667,6 +928,21 @@ void MainWindow::onVideoError(const QString& message)
     updateDetectionResult("错误: " + message);
 }
 
+void MainWindow::onFatigueStateChanged(const FatigueEvent& event)
+{
+    static const char* const kLevelText[] = {"清醒", "疲劳", "严重疲劳"};
+    const int yawnWindowMs = m_fatigueOptions.yawnWindowMs;
+    const QString yawnWindow = yawnWindowMs % 60000 == 0
+                                   ? QString("%1 分钟").arg(yawnWindowMs / 60000)
+                                   : QString("%1 秒").arg(yawnWindowMs / 1000.0, 0, 'g', 3);
+    updateDetectionResult(QString("状态：%1（PERCLOS %2%，%3内哈欠 %4 次，最长闭眼 %5 秒）")
+                              .arg(kLevelText[static_cast<int>(event.level)])
+                              .arg(event.metrics.perclos * 100, 0, 'f', 1)
+                              .arg(yawnWindow)
+                              .arg(event.metrics.yawns)
+                              .arg(event.metrics.longestClosureMs / 1000, 0, 'f', 1));
+}
+
 void MainWindow::updatePerformanceIndicator()
 {
     // 更新旋转角度
@@ -5,6 +5,11 @@
 #include <QTimer>
 #include <memory>
 #include <opencv2/opencv.hpp>
+#include "core/AppInitializer.h"
+#include "core/FatigueMonitor.h"
+#include "core/FramePool.h"
+#include "core/FrameResult.h"
+#include "ui/VideoView.h"
 
 QT_BEGIN_NAMESPACE
 class QLabel;
@@ -16,7 +21,8 @@ QT_END_NAMESPACE
 
 // Forward declarations
 class DatabaseManager;
-class DetectionEngine;
+class DetectionEnginePool;
+class EngineFactory;
 class VideoProcessor;
 class Config;
 
@@ -28,9 +34,13 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // 启动基准：依赖就绪后自动开始检测（source 为空时打开摄像头），首次检测完成后输出时间线并退出
+    void runStartupBenchmark(const QString& source);
+
 protected:
     void resizeEvent(QResizeEvent *event) override;
     void closeEvent(QCloseEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
 
 private slots:
     // 图片检测
@@ -57,7 +67,8 @@ private slots:
     void showRecords();
 
     // 帧处理
-    void onFrameReady(const cv::Mat& frame);
+    void onFrameReady(const FrameHandle& frame, const FrameResult& result);
+    void onFatigueStateChanged(const FatigueEvent& event);
 
     // 异步初始化回调
     void onSourceOpened(bool success);
@@ -72,8 +83,23 @@ private:
     void createRightPanel();
     void createSettingsButton();
     void setupConnections();
+    // 由检测结果生成显示标注（关闭标注时为空）
+    std::vector<VideoOverlay> overlaysFor(const FrameResult& result) const;
     void loadConfig();
     void saveConfig();
+    // 从配置读取各线程的 CPU 集合、调度策略和优先级
+    void configureThreadPlacement();
+    std::shared_ptr<EngineFactory> createEngineFactory() const;
+
+    // 异步初始化
+    void startInitialization();
+    void updateComponentStatus(AppInitializer::Component component,
+                               AppInitializer::State state, qint64 elapsedMs);
+    // 依赖就绪后执行 action，未就绪时排队
+    void runWhenReady(AppInitializer::Components dependencies, const QString& name,
+                      void (MainWindow::*action)());
+    // 首帧绘制和首次检测都记录后输出启动时间线，启动基准模式下随后退出
+    void finishStartupTimeline();
 
     // 检测相关
     bool shouldSaveDetection(const QString& name, double confidence);
@@ -98,9 +124,14 @@ private:
     QPushButton* m_ipcameraStartBtn;
     QPushButton* m_ipcameraStopBtn;
 
+    // 组件初始化状态
+    QLabel* m_modelStatusLabel;
+    QLabel* m_databaseStatusLabel;
+    QLabel* m_cameraStatusLabel;
+
     // UI组件 - 右侧面板
     QWidget* m_rightPanel;
-    QLabel* m_imageLabel;
+    VideoView* m_videoView;
     QLabel* m_resultLabel;
 
     // 设置按钮
@@ -108,16 +139,20 @@ private:
     QPushButton* m_recordBtn;
 
     // 核心组件
-    std::unique_ptr<DatabaseManager> m_dbManager;
-    std::unique_ptr<DetectionEngine> m_detectionEngine;
+    std::shared_ptr<DatabaseManager> m_dbManager;   // 与视频处理的输出线程共享
+    std::unique_ptr<DetectionEnginePool> m_enginePool;
     std::unique_ptr<VideoProcessor> m_videoProcessor;
     std::unique_ptr<Config> m_config;
+    std::unique_ptr<AppInitializer> m_initializer;
 
     // 状态变量
     QString m_currentModelPath;
     QString m_currentImagePath;
     QString m_currentVideoPath;
     QString m_ipCameraAddress;
+    std::vector<std::string> m_classNames;
+    bool m_showOverlays;
+    FatigueOptions m_fatigueOptions;    // 已修正的疲劳判定配置，状态文字按其窗口显示
 
     // 性能监测
     QLabel* m_performanceLabel;
@@ -128,6 +163,14 @@ private:
     int m_frameCount;
     double m_currentFPS;
 
+    // 启动时间线
+    bool m_windowPaintRecorded;
+    bool m_firstPaintRecorded;          // 画面控件绘制出第一帧
+    bool m_firstDetectionRecorded;      // 第一个真正推理的结果到达
+    QMetaObject::Connection m_firstPaintConnection;
+    QMetaObject::Connection m_firstDetectionConnection;
+    bool m_startupBenchmark;
+
     // 常量
     static constexpr int DISPLAY_WIDTH = 960;
     static constexpr int DISPLAY_HEIGHT = 540;
@@ -0,0 +1,157 @@
+#include "VideoView.h"
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPen>
+#include <algorithm>
+
+namespace {
+
+const QColor kBackgroundColor(0xEC, 0xF0, 0xF1);
+const QColor kBorderColor(0xBD, 0xC3, 0xC7);
+constexpr int kBorderWidth = 2;
+
+QImage::Format imageFormat(const cv::Mat& image)
+{
+    switch (image.type()) {
+    case CV_8UC3:
+        return QImage::Format_BGR888;
+    case CV_8UC4:
+        return QImage::Format_ARGB32;   // 小端内存顺序即 BGRA
+    case CV_8UC1:
+        return QImage::Format_Grayscale8;
+    default:
+        return QImage::Format_Invalid;
+    }
+}
+
+} // namespace
+
+VideoView::VideoView(QWidget* parent)
+    : QWidget(parent)
+    , m_transformValid(false)
+{
+    // 每次都会完整绘制背景，跳过 Qt 的背景擦除
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+VideoView::~VideoView() = default;
+
+void VideoView::setFrame(const cv::Mat& image, const FrameHandle& owner)
+{
+    const QImage::Format format = imageFormat(image);
+    if (image.empty() || format == QImage::Format_Invalid) {
+        return;
+    }
+
+    // 先持有新帧再释放旧帧
+    m_owner = owner;
+    m_mat = image;
+    m_image = QImage(m_mat.data, m_mat.cols, m_mat.rows, static_cast<qsizetype>(m_mat.step), format);
+    if (m_image.size() != m_transformImageSize) {
+        m_transformValid = false;
+    }
+    m_overlays.clear();
+    update();
+}
+
+void VideoView::setOverlays(std::vector<VideoOverlay> overlays, const QSize& coordinateSize)
+{
+    m_overlays = std::move(overlays);
+    m_overlaySize = coordinateSize;
+    update();
+}
+
+void VideoView::clear()
+{
+    m_image = QImage();
+    m_mat.release();
+    m_owner.reset();
+    m_overlays.clear();
+    update();
+}
+
+void VideoView::setPlaceholderText(const QString& text)
+{
+    m_placeholderText = text;
+    if (!hasFrame()) {
+        update();
+    }
+}
+
+void VideoView::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    m_transformValid = false;
+}
+
+void VideoView::updateTransform()
+{
+    const QRectF area = QRectF(rect()).adjusted(kBorderWidth, kBorderWidth,
+                                                -kBorderWidth, -kBorderWidth);
+    const QSizeF imageSize = m_image.size();
+    const double scale = std::min(area.width() / imageSize.width(),
+                                  area.height() / imageSize.height());
+    const QSizeF scaled = imageSize * scale;
+
+    m_targetRect = QRectF(area.x() + (area.width() - scaled.width()) / 2.0,
+                          area.y() + (area.height() - scaled.height()) / 2.0,
+                          scaled.width(), scaled.height());
+    m_imageToWidget = QTransform::fromTranslate(m_targetRect.x(), m_targetRect.y())
+                          .scale(scale, scale);
+    m_transformImageSize = m_image.size();
+    m_transformValid = true;
+}
+
+void VideoView::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), kBackgroundColor);
+
+    if (m_image.isNull()) {
+        painter.setPen(QColor(0x2C, 0x3E, 0x50));
+        painter.drawText(rect(), Qt::AlignCenter, m_placeholderText);
+    } else {
+        if (!m_transformValid) {
+            updateTransform();
+        }
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawImage(m_targetRect, m_image);
+
+        // 标注在控件坐标下绘制，线宽和字号不随画面缩放
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        const QFontMetrics metrics = painter.fontMetrics();
+        QTransform overlayToWidget = m_imageToWidget;
+        if (m_overlaySize.isValid() && m_overlaySize != m_image.size()) {
+            overlayToWidget = QTransform::fromScale(
+                                  static_cast<double>(m_image.width()) / m_overlaySize.width(),
+                                  static_cast<double>(m_image.height()) / m_overlaySize.height())
+                              * m_imageToWidget;
+        }
+        for (const VideoOverlay& overlay : m_overlays) {
+            const QRectF box = overlayToWidget.mapRect(overlay.box);
+            painter.setPen(QPen(overlay.color, 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawRect(box);
+
+            if (!overlay.label.isEmpty()) {
+                const QRectF textRect(box.left(), box.top() - metrics.height(),
+                                      metrics.horizontalAdvance(overlay.label) + 6, metrics.height());
+                painter.fillRect(textRect, overlay.color);
+                painter.setPen(Qt::black);
+                painter.drawText(textRect, Qt::AlignCenter, overlay.label);
+            }
+        }
+    }
+
+    painter.setPen(QPen(kBorderColor, kBorderWidth));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(QRectF(rect()).adjusted(kBorderWidth / 2.0, kBorderWidth / 2.0,
+                                             -kBorderWidth / 2.0, -kBorderWidth / 2.0));
+    painter.end();
+
+    if (!m_image.isNull()) {
+        emit framePainted();
+    }
+}
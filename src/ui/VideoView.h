@@ -0,0 +1,69 @@
+#ifndef VIDEOVIEW_H
+#define VIDEOVIEW_H
+
+#include <QColor>
+#include <QImage>
+#include <QRectF>
+#include <QString>
+#include <QTransform>
+#include <QWidget>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "../core/FramePool.h"
+
+// 叠加在画面上的标注，坐标所在的空间由 setOverlays 指定
+struct VideoOverlay {
+    QRectF box;
+    QString label;
+    QColor color;
+};
+
+// 视频显示控件：在 paintEvent 中直接绘制 BGR 帧，不做颜色转换和像素拷贝。
+// 图像到控件的缩放变换只在控件或帧尺寸变化时重新计算，标注用 QPainter 绘制
+class VideoView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit VideoView(QWidget* parent = nullptr);
+    ~VideoView();
+
+    // 显示一帧。owner 非空时持有池句柄，保证绘制期间缓冲区不被复用；
+    // 否则 image 的引用计数保证数据有效。新帧会清除上一帧的标注
+    void setFrame(const cv::Mat& image, const FrameHandle& owner = FrameHandle());
+    // coordinateSize 为标注坐标对应的图像尺寸（如检测用的源分辨率），
+    // 为空时按当前帧的像素坐标
+    void setOverlays(std::vector<VideoOverlay> overlays, const QSize& coordinateSize = QSize());
+
+    // 清除画面并显示提示文字
+    void clear();
+    void setPlaceholderText(const QString& text);
+
+    bool hasFrame() const { return !m_image.isNull(); }
+
+signals:
+    // 每次绘制出视频帧（而非占位文字）后发出
+    void framePainted();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    void updateTransform();
+
+    cv::Mat m_mat;              // 保持非池图像的数据有效
+    FrameHandle m_owner;
+    QImage m_image;             // 引用 m_mat 的像素，不拷贝
+    std::vector<VideoOverlay> m_overlays;
+    QSize m_overlaySize;
+    QString m_placeholderText;
+
+    // 缓存的缩放结果
+    QRectF m_targetRect;
+    QTransform m_imageToWidget;
+    QSize m_transformImageSize;
+    bool m_transformValid;
+};
+
+#endif // VIDEOVIEW_H
@@ -0,0 +1,860 @@
+#include "Benchmark.h"
+#include "Config.h"
+#include "../core/DetectionEngine.h"
+#include "../core/DetectionTracker.h"
+#include "../core/FatigueMonitor.h"
+#include "../core/FrameMailbox.h"
+#include "../core/FramePacer.h"
+#include "../core/FramePool.h"
+#include "../core/MotionGate.h"
+#include "../core/NonMaxSuppression.h"
+#include "../core/Preprocessor.h"
+#include "../core/YoloDecoder.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <opencv2/opencv.hpp>
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kInputWidth = 640;
+constexpr int kInputHeight = 640;
+
+// 原 DetectionEngine 的预处理路径：letterbox + convertTo + split + memcpy
+void legacyPreprocess(const cv::Mat& src, std::vector<float>& inputData)
+{
+    float scale = std::min(static_cast<float>(kInputWidth) / src.cols,
+                           static_cast<float>(kInputHeight) / src.rows);
+    int newWidth = static_cast<int>(src.cols * scale);
+    int newHeight = static_cast<int>(src.rows * scale);
+
+    cv::Mat scaled;
+    cv::resize(src, scaled, cv::Size(newWidth, newHeight));
+
+    cv::Mat padded = cv::Mat::zeros(cv::Size(kInputWidth, kInputHeight), src.type());
+    padded.setTo(cv::Scalar(114, 114, 114));
+    int top = (kInputHeight - newHeight) / 2;
+    int left = (kInputWidth - newWidth) / 2;
+    scaled.copyTo(padded(cv::Rect(left, top, newWidth, newHeight)));
+
+    inputData.assign(3 * kInputWidth * kInputHeight, 0.0f);
+    cv::Mat floatImage;
+    padded.convertTo(floatImage, CV_32F, 1.0 / 255.0);
+
+    std::vector<cv::Mat> channels(3);
+    cv::split(floatImage, channels);
+    for (int c = 0; c < 3; ++c) {
+        std::memcpy(inputData.data() + c * kInputHeight * kInputWidth,
+                    channels[c].data,
+                    kInputHeight * kInputWidth * sizeof(float));
+    }
+}
+
+// 原 DetectionEngine::nms：全类别 O(n^2) 抑制
+std::vector<Detection> legacyNms(std::vector<Detection>& detections, float nmsThreshold)
+{
+    std::sort(detections.begin(), detections.end(),
+              [](const Detection& a, const Detection& b) {
+                  return a.confidence > b.confidence;
+              });
+
+    std::vector<Detection> result;
+    std::vector<bool> suppressed(detections.size(), false);
+    for (size_t i = 0; i < detections.size(); ++i) {
+        if (suppressed[i]) {
+            continue;
+        }
+        result.push_back(detections[i]);
+        for (size_t j = i + 1; j < detections.size(); ++j) {
+            if (suppressed[j]) {
+                continue;
+            }
+            cv::Rect intersection = detections[i].bbox & detections[j].bbox;
+            float intersectionArea = intersection.area();
+            float unionArea = detections[i].bbox.area() + detections[j].bbox.area() - intersectionArea;
+            if (unionArea > 0 && intersectionArea / unionArea > nmsThreshold) {
+                suppressed[j] = true;
+            }
+        }
+    }
+    return result;
+}
+
+double msPerIteration(qint64 nsecs, int iterations)
+{
+    return nsecs / 1e6 / iterations;
+}
+
+// 统计 cv::Mat 像素缓冲区分配次数的分配器，实际分配交给 OpenCV 默认分配器
+class CountingAllocator : public cv::MatAllocator
+{
+public:
+    explicit CountingAllocator(cv::MatAllocator* base) : m_base(base) {}
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        if (!data) {
+            m_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        // 缓冲区仍由默认分配器释放
+        return m_base->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags,
+                  cv::UMatUsageFlags usageFlags) const override
+    {
+        return m_base->allocate(data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* data) const override
+    {
+        m_base->deallocate(data);
+    }
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+private:
+    cv::MatAllocator* m_base;
+    mutable std::atomic<uint64_t> m_count{0};
+};
+
+// 原视频流程每帧的图像处理：解码到新 Mat、缩放到新 Mat、界面转换到新 Mat
+void legacyFrameFlow(const cv::Mat& decoded, const cv::Size& displaySize, cv::Mat& shown)
+{
+    cv::Mat captured = decoded.clone();
+    cv::Mat display;
+    cv::resize(captured, display, displaySize);
+    cv::Mat rgb;
+    cv::cvtColor(display, rgb, cv::COLOR_BGR2RGB);
+    shown = rgb;
+}
+
+// 按每帧推理的基准统计疲劳片段，检查被测路径在每个片段内至少有一帧给出同样的类别
+struct EpisodeReplay {
+    explicit EpisodeReplay(const std::vector<int>& classes)
+        : fatigueClasses(classes)
+        , inEpisode(classes.size(), false)
+        , episodeHit(classes.size(), false)
+    {
+    }
+
+    void add(uint32_t referenceMask, uint32_t candidateMask)
+    {
+        if (referenceMask != candidateMask) {
+            ++mismatchedFrames;
+        }
+        for (size_t i = 0; i < fatigueClasses.size(); ++i) {
+            const uint32_t bit = 1u << fatigueClasses[i];
+            if (referenceMask & bit) {
+                if (!inEpisode[i]) {
+                    inEpisode[i] = true;
+                    episodeHit[i] = false;
+                }
+                episodeHit[i] = episodeHit[i] || (candidateMask & bit);
+            } else if (inEpisode[i]) {
+                close(i);
+            }
+        }
+    }
+
+    void finish()
+    {
+        for (size_t i = 0; i < fatigueClasses.size(); ++i) {
+            if (inEpisode[i]) {
+                close(i);
+            }
+        }
+    }
+
+    void close(size_t i)
+    {
+        ++episodes;
+        if (!episodeHit[i]) {
+            ++missed;
+        }
+        inEpisode[i] = false;
+    }
+
+    std::vector<int> fatigueClasses;
+    std::vector<bool> inEpisode;
+    std::vector<bool> episodeHit;
+    int episodes = 0;
+    int missed = 0;
+    uint64_t mismatchedFrames = 0;
+};
+
+} // namespace
+
+int Benchmark::run(const QStringList& args)
+{
+    int index = args.indexOf("--benchmark");
+    if (index < 0 || index + 1 >= args.size()) {
+        qDebug() << "Usage: --benchmark <image> [model]";
+        return 1;
+    }
+
+    const QString imagePath = args.at(index + 1);
+    QString modelPath;
+    if (index + 2 < args.size()) {
+        modelPath = args.at(index + 2);
+    } else {
+        Config config;
+        config.load();
+        modelPath = QString::fromStdString(config.getModelPath());
+    }
+
+    benchmarkPreprocess(imagePath, 200);
+    benchmarkInference(imagePath, modelPath, 50);
+    benchmarkDecode(200);
+    benchmarkNms(50);
+    benchmarkBatch(imagePath, modelPath, 20);
+    benchmarkMatBuffers(imagePath, 1000);
+    return benchmarkPacer(60) ? 0 : 1;
+}
+
+void Benchmark::benchmarkPreprocess(const QString& imagePath, int iterations)
+{
+    cv::Mat image = cv::imread(imagePath.toStdString());
+    if (image.empty()) {
+        qDebug() << "Benchmark: failed to read" << imagePath;
+        return;
+    }
+
+    std::vector<float> legacyOutput;
+    std::vector<float> fusedOutput(3 * kInputWidth * kInputHeight);
+    Preprocessor preprocessor;
+
+    // 预热，并校验两条路径输出一致
+    legacyPreprocess(image, legacyOutput);
+    preprocessor.letterboxToCHW(image, fusedOutput.data(), kInputWidth, kInputHeight);
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < fusedOutput.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(fusedOutput[i] - legacyOutput[i]));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        legacyPreprocess(image, legacyOutput);
+    }
+    const qint64 legacyNs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        preprocessor.letterboxToCHW(image, fusedOutput.data(), kInputWidth, kInputHeight);
+    }
+    const qint64 fusedNs = timer.nsecsElapsed();
+
+    qDebug() << "Preprocess benchmark" << image.cols << "x" << image.rows
+             << "->" << kInputWidth << "x" << kInputHeight;
+    qDebug() << "  legacy:" << msPerIteration(legacyNs, iterations) << "ms/frame";
+    qDebug() << "  fused: " << msPerIteration(fusedNs, iterations) << "ms/frame";
+    qDebug() << "  max abs diff:" << maxDiff;
+}
+
+void Benchmark::benchmarkInference(const QString& imagePath, const QString& modelPath,
+                                   int iterations)
+{
+    cv::Mat image = cv::imread(imagePath.toStdString());
+    if (image.empty()) {
+        return;
+    }
+
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "Benchmark");
+        Ort::SessionOptions options;
+        options.SetIntraOpNumThreads(4);
+        options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+#ifdef _WIN32
+        Ort::Session session(env, modelPath.toStdWString().c_str(), options);
+#else
+        Ort::Session session(env, modelPath.toStdString().c_str(), options);
+#endif
+
+        std::vector<int64_t> inputShape =
+            session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        std::vector<int64_t> outputShape =
+            session.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        size_t inputSize = 1;
+        for (int64_t d : inputShape) inputSize *= static_cast<size_t>(d);
+        size_t outputSize = 1;
+        for (int64_t d : outputShape) outputSize *= static_cast<size_t>(d);
+
+        Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::vector<float> input(inputSize);
+        Preprocessor preprocessor;
+        preprocessor.letterboxToCHW(image, input.data(),
+                                    static_cast<int>(inputShape[3]),
+                                    static_cast<int>(inputShape[2]));
+
+        // 旧路径：逐帧查询名称、创建张量、拷贝输出
+        auto legacyRun = [&]() {
+            Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+                memoryInfo, input.data(), input.size(), inputShape.data(), inputShape.size());
+            Ort::AllocatedStringPtr inputNamePtr =
+                session.GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
+            Ort::AllocatedStringPtr outputNamePtr =
+                session.GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions());
+            const char* inputName = inputNamePtr.get();
+            const char* outputName = outputNamePtr.get();
+            auto outputs = session.Run(Ort::RunOptions{nullptr},
+                                       &inputName, &inputTensor, 1, &outputName, 1);
+            float* data = outputs[0].GetTensorMutableData<float>();
+            std::vector<float> copy(data, data + outputSize);
+            return copy[0];
+        };
+
+        // 新路径：IoBinding 绑定预分配缓冲
+        std::vector<float> output(outputSize);
+        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+            memoryInfo, input.data(), input.size(), inputShape.data(), inputShape.size());
+        Ort::Value outputTensor = Ort::Value::CreateTensor<float>(
+            memoryInfo, output.data(), output.size(), outputShape.data(), outputShape.size());
+        Ort::IoBinding binding(session);
+        binding.BindInput(session.GetInputNameAllocated(0, Ort::AllocatorWithDefaultOptions()).get(),
+                          inputTensor);
+        binding.BindOutput(session.GetOutputNameAllocated(0, Ort::AllocatorWithDefaultOptions()).get(),
+                           outputTensor);
+
+        legacyRun();
+        session.Run(Ort::RunOptions{nullptr}, binding);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            legacyRun();
+        }
+        const qint64 legacyNs = timer.nsecsElapsed();
+
+        timer.restart();
+        for (int i = 0; i < iterations; ++i) {
+            session.Run(Ort::RunOptions{nullptr}, binding);
+        }
+        const qint64 boundNs = timer.nsecsElapsed();
+
+        qDebug() << "Inference benchmark" << modelPath;
+        qDebug() << "  per-call names + output copy:" << msPerIteration(legacyNs, iterations) << "ms/frame";
+        qDebug() << "  IoBinding:                   " << msPerIteration(boundNs, iterations) << "ms/frame";
+    } catch (const Ort::Exception& e) {
+        qDebug() << "Benchmark: inference failed:" << e.what();
+    }
+}
+
+void Benchmark::benchmarkDecode(int iterations)
+{
+    // 随机分数模拟 [1, 7, 8400] 输出，低阈值下大量 anchor 通过
+    const std::vector<int64_t> shape = {1, 7, 8400};
+    std::vector<float> output(7 * 8400);
+    cv::randu(cv::Mat(1, static_cast<int>(output.size()), CV_32F, output.data()), 0.0f, 1.0f);
+
+    std::vector<DecodedBox> candidates;
+    for (float threshold : {0.9f, 0.5f, 0.25f, 0.05f}) {
+        YoloDecoder::decode(output.data(), shape, threshold, candidates);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            YoloDecoder::decode(output.data(), shape, threshold, candidates);
+        }
+        qDebug() << "Decode threshold" << threshold << ":"
+                 << candidates.size() << "candidates,"
+                 << msPerIteration(timer.nsecsElapsed(), iterations) << "ms/frame";
+    }
+}
+
+void Benchmark::benchmarkNms(int iterations)
+{
+    cv::RNG rng(12345);
+    const char* names[] = {"dahaqian", "biyanjing", "normal"};
+
+    for (int count : {10, 1000, 8000}) {
+        // 候选框聚集在少量目标附近，模拟低阈值下的真实分布
+        std::vector<DecodedBox> candidates(count);
+        std::vector<Detection> detections(count);
+        for (int i = 0; i < count; ++i) {
+            const float cx = 100.0f + 100.0f * (i % 5) + rng.uniform(-8.0f, 8.0f);
+            const float cy = 320.0f + rng.uniform(-8.0f, 8.0f);
+            const float size = rng.uniform(40.0f, 60.0f);
+            DecodedBox& box = candidates[i];
+            box = {cx - size / 2, cy - size / 2, cx + size / 2, cy + size / 2,
+                   rng.uniform(0.05f, 1.0f), i % 3};
+            detections[i].bbox = cv::Rect(cv::Point(static_cast<int>(box.x1), static_cast<int>(box.y1)),
+                                          cv::Point(static_cast<int>(box.x2), static_cast<int>(box.y2)));
+            detections[i].confidence = box.score;
+            detections[i].classId = box.classId;
+            detections[i].className = names[box.classId];
+        }
+
+        // 旧实现原地排序，每次迭代的输入副本在计时前准备好，不把字符串拷贝算进去
+        std::vector<std::vector<Detection>> copies(iterations, detections);
+
+        QElapsedTimer timer;
+        timer.start();
+        size_t legacyKept = 0;
+        for (int i = 0; i < iterations; ++i) {
+            legacyKept = legacyNms(copies[i], 0.45f).size();
+        }
+        const qint64 legacyNs = timer.nsecsElapsed();
+
+        NonMaxSuppression nms;
+        std::vector<int> keep;
+        timer.restart();
+        for (int i = 0; i < iterations; ++i) {
+            nms.run(candidates, 0.45f, 300, keep);
+        }
+        const qint64 fastNs = timer.nsecsElapsed();
+
+        qDebug() << "NMS" << count << "candidates:"
+                 << "legacy" << msPerIteration(legacyNs, iterations) << "ms (" << legacyKept << "kept),"
+                 << "SoA top-300 per-class" << msPerIteration(fastNs, iterations) << "ms ("
+                 << keep.size() << "kept)";
+    }
+}
+
+void Benchmark::benchmarkBatch(const QString& imagePath, const QString& modelPath,
+                               int iterations)
+{
+    cv::Mat image = cv::imread(imagePath.toStdString());
+    if (image.empty()) {
+        return;
+    }
+
+    DetectionEngine engine;
+    if (!engine.loadModel(modelPath.toStdString())) {
+        qDebug() << "Benchmark: failed to load" << modelPath;
+        return;
+    }
+
+    if (!engine.supportsDynamicBatch()) {
+        qDebug() << "Batch benchmark: model has a fixed batch size, frames run one by one";
+    }
+
+    const int cores = engine.getIntraOpThreads();
+    for (int batch : {1, 2, 4, 8}) {
+        std::vector<cv::Mat> frames(batch, image);
+        engine.detectBatch(frames);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            engine.detectBatch(frames);
+        }
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        const double fps = batch * iterations / seconds;
+
+        qDebug() << "Batch N =" << batch
+                 << ":" << fps << "frames/s,"
+                 << fps / cores << "frames/s per core ("
+                 << cores << "intra-op threads)";
+    }
+}
+
+void Benchmark::benchmarkMatBuffers(const QString& imagePath, int iterations)
+{
+    cv::Mat decoded = cv::imread(imagePath.toStdString());
+    if (decoded.empty()) {
+        qDebug() << "Benchmark: failed to read" << imagePath;
+        return;
+    }
+    const cv::Size displaySize(960, 540);
+
+    CountingAllocator allocator(cv::Mat::getDefaultAllocator());
+    cv::Mat::setDefaultAllocator(&allocator);
+
+    // 原流程：每帧都分配新的 Mat
+    cv::Mat shown;
+    uint64_t before = allocator.count();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        legacyFrameFlow(decoded, displaySize, shown);
+    }
+    const qint64 legacyNs = timer.nsecsElapsed();
+    const uint64_t legacyAllocations = allocator.count() - before;
+
+    // 池化流程：采集池 → 显示池 → 信箱 → VideoView 直接绘制 BGR，与 VideoProcessor 的缓冲区流转一致；
+    // 不经过推理和 Qt 信号，这些环节的其他堆分配不在此统计
+    std::shared_ptr<FramePool> capturePool = FramePool::create(decoded.size(), decoded.type(), 4);
+    std::shared_ptr<FramePool> displayPool = FramePool::create(displaySize, decoded.type(), 4);
+    FrameMailbox mailbox;
+    FrameResult result{};
+    FrameHandle shownFrame;    // 模拟 VideoView 持有的上一帧
+
+    auto runFrame = [&]() {
+        FrameHandle captured = capturePool->acquire();
+        decoded.copyTo(captured.mat());
+        FrameHandle display = displayPool->acquire();
+        cv::resize(captured.mat(), display.mat(), displaySize);
+        captured.reset();
+        mailbox.post(display, result);
+        display.reset();
+
+        mailbox.take(shownFrame, result);
+    };
+    runFrame();    // 预热
+
+    before = allocator.count();
+    timer.restart();
+    for (int i = 0; i < iterations; ++i) {
+        runFrame();
+    }
+    const qint64 pooledNs = timer.nsecsElapsed();
+    const uint64_t pooledAllocations = allocator.count() - before;
+
+    cv::Mat::setDefaultAllocator(nullptr);
+
+    qDebug() << "Frame Mat buffers" << iterations << "frames:"
+             << "legacy" << msPerIteration(legacyNs, iterations) << "ms/frame,"
+             << legacyAllocations << "Mat allocations |"
+             << "pooled" << msPerIteration(pooledNs, iterations) << "ms/frame,"
+             << pooledAllocations << "Mat allocations,"
+             << capturePool->allocatedBuffers() + displayPool->allocatedBuffers() << "pooled buffers"
+             << (pooledAllocations == 0 ? "(no Mat buffer allocations in steady state)"
+                                        : "(UNEXPECTED MAT ALLOCATIONS)");
+}
+
+bool Benchmark::benchmarkPacer(int frames)
+{
+    // 30fps 源，按采集线程的顺序：grab() 每帧都有开销，schedule() 通过后才 retrieve() 并等到截止时刻。
+    // 解码开销加在虚拟时钟上；grab 比帧间隔慢时丢帧也追不上
+    using Clock = FramePacer::Clock;
+    const double fps = 30.0;
+    const std::pair<int, int> costs[] = {{2, 8}, {10, 40}, {40, 10}};
+    bool progressing = true;
+    for (const auto& [grabMs, retrieveMs] : costs) {
+        FramePacer pacer;
+        pacer.reset(fps, FramePacer::Mode::RealTime);
+
+        const Clock::time_point start = Clock::now();
+        Clock::time_point now = start;
+        Clock::time_point lastShown = start;
+        Clock::duration longestGap = Clock::duration::zero();
+        int shown = 0;
+        for (int i = 0; i < frames; ++i) {
+            now += std::chrono::milliseconds(grabMs);
+            if (!pacer.schedule(i * 1000.0 / fps, now)) {
+                continue;
+            }
+            now += std::chrono::milliseconds(retrieveMs);
+            now = std::max(now, pacer.deadline());
+            longestGap = std::max(longestGap, now - lastShown);
+            lastShown = now;
+            ++shown;
+        }
+        longestGap = std::max(longestGap, now - lastShown);
+        const qint64 longestGapMs =
+            std::chrono::duration_cast<std::chrono::milliseconds>(longestGap).count();
+
+        // 画面停顿不应超过丢帧上限（约 1/4 秒）加两帧的解码时间和一个帧间隔
+        const bool stalled = longestGapMs > 250 + 2 * (grabMs + retrieveMs) + 1000.0 / fps;
+        progressing = progressing && !stalled;
+        qDebug() << "Pacer real-time, grab" << grabMs << "ms + retrieve" << retrieveMs << "ms:"
+                 << shown << "/" << frames << "frames shown,"
+                 << pacer.skippedFrames() << "skipped," << pacer.reanchorCount() << "re-anchored,"
+                 << "longest gap" << longestGapMs << "ms" << (stalled ? "(STALLED)" : "");
+    }
+    return progressing;
+}
+
+int Benchmark::replayMotionGate(const QStringList& args)
+{
+    const int index = args.indexOf("--gate-replay");
+    QStringList clips;
+    for (int i = index + 1; i < args.size() && !args.at(i).startsWith("--"); ++i) {
+        clips << args.at(i);
+    }
+    if (clips.isEmpty()) {
+        qDebug() << "Usage: --gate-replay <video> [video...]";
+        return 1;
+    }
+
+    // 门限参数与模型取自配置，与实际运行一致
+    Config config;
+    config.load();
+    MotionGateOptions options;
+    options.threshold = config.getMotionGateThreshold();
+    options.refreshIntervalMs = config.getMotionGateRefreshMs();
+    TrackerOptions trackerOptions;
+    trackerOptions.detectInterval = std::max(1, config.getTrackerDetectInterval());
+    trackerOptions.cascadeDetectInterval = std::max(1, config.getCascadeDetectInterval());
+    trackerOptions.regionInference = false;
+
+    DetectionEngine engine;
+    engine.setStateClassifiers(config.getCascadeEyeModelPath(), config.getCascadeMouthModelPath());
+    ClassRoles classRoles = engine.classRoles();
+    classRoles.eyesClosed = config.getFatigueEyesClosedClass();
+    classRoles.yawn = config.getFatigueYawnClass();
+    engine.setClassRoles(classRoles);
+    if (!engine.loadModel(config.getModelPath())) {
+        qDebug() << "Gate replay: failed to load" << QString::fromStdString(config.getModelPath());
+        return 1;
+    }
+
+    int missed = 0;
+    for (const QString& clip : clips) {
+        const int clipMissed = replayClip(engine, clip, options, trackerOptions);
+        if (clipMissed < 0) {
+            return 1;
+        }
+        missed += clipMissed;
+    }
+
+    qDebug() << "Gate replay:" << (missed == 0 ? "PASS" : "FAIL") << "-" << missed
+             << "fatigue episodes missed over" << clips.size() << "clips";
+    return missed == 0 ? 0 : 2;
+}
+
+int Benchmark::replayClip(DetectionEngine& engine, const QString& clipPath,
+                          const MotionGateOptions& gateOptions,
+                          const TrackerOptions& trackerOptions)
+{
+    cv::VideoCapture capture(clipPath.toStdString());
+    if (!capture.isOpened()) {
+        qDebug() << "Gate replay: failed to open" << clipPath;
+        return -1;
+    }
+
+    // 闭眼和哈欠算疲劳状态
+    const ClassRoles roles = engine.classRoles();
+    std::vector<int> fatigueClasses;
+    for (int classId : {roles.eyesClosed, roles.yawn}) {
+        if (classId >= 0) {
+            fatigueClasses.push_back(classId);
+        }
+    }
+    auto classMask = [](const std::vector<Detection>& detections) {
+        uint32_t mask = 0;
+        for (const Detection& det : detections) {
+            if (det.classId >= 0 && det.classId < 32) {
+                mask |= 1u << det.classId;
+            }
+        }
+        return mask;
+    };
+    auto resultMask = [](const FrameResult& result) {
+        uint32_t mask = 0;
+        for (int i = 0; i < result.count; ++i) {
+            // 已丢失检测的轨迹只沿用旧类别，不算作本帧的检测
+            if (result.detections[i].trackMisses > 0) {
+                continue;
+            }
+            const int classId = result.detections[i].classId;
+            if (classId >= 0 && classId < 32) {
+                mask |= 1u << classId;
+            }
+        }
+        return mask;
+    };
+
+    // 路径 1：只有门限，变化不足时沿用上次推理的结果
+    MotionGate gate(gateOptions);
+    std::vector<Detection> reused;
+    bool hasReused = false;
+    EpisodeReplay gated(fatigueClasses);
+
+    // 路径 2：与推理线程相同的门限 + 跟踪器：到推理间隔且画面有变化才推理，其余帧用轨迹预测
+    MotionGate trackerGate(gateOptions);
+    DetectionTracker tracker(trackerOptions);
+    uint64_t trackerInferred = 0;
+    EpisodeReplay tracked(fatigueClasses);
+
+    // 路径 3：与推理线程相同的级联：门限只拦截检测帧，其余每帧由分类器在确认的轨迹上判断状态
+    const bool cascade = engine.supportsStateClassifier();
+    MotionGate cascadeGate(gateOptions);
+    DetectionTracker cascadeTracker(trackerOptions);
+    uint64_t cascadeInferred = 0;
+    EpisodeReplay cascaded(fatigueClasses);
+
+    uint64_t frames = 0;
+    qint64 modelNs = 0;
+    cv::Mat frame;
+    QElapsedTimer timer;
+    while (capture.read(frame) && !frame.empty()) {
+        const int64_t timestampNs = static_cast<int64_t>(capture.get(cv::CAP_PROP_POS_MSEC) * 1e6);
+
+        // 基准：每帧都推理
+        timer.restart();
+        const std::vector<Detection> reference = engine.detect(frame);
+        modelNs += timer.nsecsElapsed();
+        const uint32_t referenceMask = classMask(reference);
+
+        if (gate.shouldInfer(frame, timestampNs) || !hasReused) {
+            reused = reference;
+            hasReused = true;
+        }
+        gated.add(referenceMask, classMask(reused));
+
+        FrameResult result{};
+        result.imageWidth = frame.cols;
+        result.imageHeight = frame.rows;
+        if (tracker.detectionDue(frame.size()) && trackerGate.shouldInfer(frame, timestampNs)) {
+            result.assign(reference);
+            tracker.update(result, timestampNs);
+            ++trackerInferred;
+        } else {
+            tracker.predict(result, timestampNs);
+        }
+        tracked.add(referenceMask, resultMask(result));
+
+        if (cascade) {
+            FrameResult cascadeResult{};
+            cascadeResult.imageWidth = frame.cols;
+            cascadeResult.imageHeight = frame.rows;
+            if (cascadeTracker.detectionDue(frame.size(), true)
+                && cascadeGate.shouldInfer(frame, timestampNs)) {
+                cascadeResult.assign(reference);
+                cascadeTracker.update(cascadeResult, timestampNs);
+                ++cascadeInferred;
+            } else {
+                cascadeTracker.predict(cascadeResult, timestampNs);
+                for (int i = 0; i < cascadeResult.count; ++i) {
+                    FrameDetection& det = cascadeResult.detections[i];
+                    if (det.trackHits < trackerOptions.minHits || det.trackMisses > 0) {
+                        continue;
+                    }
+                    float score = 0.0f;
+                    const int classId = engine.classifyState(
+                        frame, cv::Rect2f(det.x, det.y, det.width, det.height), score);
+                    if (classId >= 0) {
+                        det.classId = classId;
+                        cascadeTracker.reclassify(det.trackId, classId, score);
+                    }
+                }
+            }
+            cascaded.add(referenceMask, resultMask(cascadeResult));
+        }
+        ++frames;
+    }
+    gated.finish();
+    tracked.finish();
+    cascaded.finish();
+
+    const double modelMs = frames > 0 ? modelNs / 1e6 / frames : 0.0;
+    const double skipRatio = frames > 0 ? static_cast<double>(gate.skippedFrames()) / frames : 0.0;
+    qDebug() << "Gate replay" << clipPath << ":" << frames << "frames,"
+             << gate.skippedFrames() << "skipped (" << skipRatio * 100.0 << "% )";
+    qDebug() << "  model" << modelMs << "ms/frame, gate" << gate.averageCostMs()
+             << "ms/frame, CPU saved ~"
+             << gate.skippedFrames() * modelMs - frames * gate.averageCostMs() << "ms";
+    qDebug() << "  gate only: fatigue episodes" << gated.episodes << ", missed" << gated.missed
+             << ", frames with differing classes" << gated.mismatchedFrames;
+    qDebug() << "  gate + tracker (interval" << trackerOptions.detectInterval << "):"
+             << trackerInferred << "inferred, fatigue episodes" << tracked.episodes
+             << ", missed" << tracked.missed
+             << ", frames with differing classes" << tracked.mismatchedFrames;
+    if (cascade) {
+        qDebug() << "  gate + cascade (interval" << trackerOptions.cascadeDetectInterval << "):"
+                 << cascadeInferred << "inferred, fatigue episodes" << cascaded.episodes
+                 << ", missed" << cascaded.missed
+                 << ", frames with differing classes" << cascaded.mismatchedFrames;
+    }
+    return gated.missed + tracked.missed + cascaded.missed;
+}
+
+int Benchmark::replayFatigue(const QStringList& args)
+{
+    Q_UNUSED(args);
+
+    // 类别 ID 只需互不相同，与模型无关
+    ClassRoles roles;
+    roles.yawn = 0;
+    roles.eyesClosed = 1;
+    roles.normal = 2;
+    const int open = roles.normal;
+    const int closed = roles.eyesClosed;
+    const int yawn = roles.yawn;
+    const int noFace = -1;
+    const int coasting = -2;
+
+    // classAt 给出每个时刻（毫秒）驾驶员的状态类别，noFace 表示本帧没有检测，
+    // coasting 表示轨迹已丢失检测、仍带着丢失前的闭眼类别输出
+    struct Scenario {
+        const char* name;
+        int durationMs;
+        std::function<int(int)> classAt;
+        FatigueLevel expected;
+        int expectedEvents;
+    };
+    const std::vector<Scenario> scenarios = {
+        {"blinks", 60000, [=](int t) { return t % 4000 < 150 ? closed : open; },
+         FatigueLevel::Alert, 0},
+        {"perclos 20%", 60000, [=](int t) { return t % 2000 < 400 ? closed : open; },
+         FatigueLevel::Drowsy, 1},
+        {"perclos 35%", 60000, [=](int t) { return t % 2000 < 700 ? closed : open; },
+         FatigueLevel::Critical, 1},
+        {"long closure", 30000, [=](int t) { return (t >= 20000 && t < 22500) ? closed : open; },
+         FatigueLevel::Critical, 2},
+        {"3 yawns", 90000, [=](int t) { return (t % 30000 >= 10000 && t % 30000 < 13000) ? yawn : open; },
+         FatigueLevel::Drowsy, 1},
+        {"5 yawns", 100000, [=](int t) { return (t % 20000 >= 5000 && t % 20000 < 8000) ? yawn : open; },
+         FatigueLevel::Critical, 2},
+        // 长闭眼移出 PERCLOS 窗口并持续 recoveryMs 后降级
+        {"recovery", 80000, [=](int t) { return (t >= 5000 && t < 7500) ? closed : open; },
+         FatigueLevel::Alert, 3},
+        // 人脸短暂丢失打断闭眼，两段都不足 drowsyClosureMs
+        {"face lost", 15000, [=](int t) {
+             if (t >= 10800 && t < 11300) {
+                 return noFace;
+             }
+             return (t >= 10000 && t < 12100) ? closed : open;
+         },
+         FatigueLevel::Alert, 0},
+        // 闭眼 600 ms 后人脸丢失，轨迹沿用闭眼类别外推 1.4 s，不能算作 2 s 闭眼
+        {"coasting track", 15000, [=](int t) {
+             if (t >= 10600 && t < 12000) {
+                 return coasting;
+             }
+             return (t >= 10000 && t < 10600) ? closed : open;
+         },
+         FatigueLevel::Alert, 0},
+    };
+
+    const int64_t frameNs = 1000000000LL / 30;
+    int failed = 0;
+    for (const Scenario& scenario : scenarios) {
+        FatigueMonitor monitor;
+        monitor.setClassRoles(roles);
+
+        int events = 0;
+        const int64_t endNs = static_cast<int64_t>(scenario.durationMs) * 1000000;
+        for (int64_t ns = 0; ns < endNs; ns += frameNs) {
+            FrameResult result{};
+            result.captureNs = ns;
+            const int classId = scenario.classAt(static_cast<int>(ns / 1000000));
+            if (classId == coasting) {
+                result.count = 1;
+                result.detections[0] = {100.0f, 100.0f, 80.0f, 80.0f, 0.9f, closed, 1, 10, 1};
+            } else if (classId != noFace) {
+                result.count = 1;
+                result.detections[0] = {100.0f, 100.0f, 80.0f, 80.0f, 0.9f, classId, 1, 10, 0};
+            }
+            if (monitor.update(result)) {
+                ++events;
+                const FatigueEvent& event = monitor.lastEvent();
+                qDebug() << "  " << scenario.name << ns / 1e9 << "s:"
+                         << fatigueLevelName(event.previous) << "->" << fatigueLevelName(event.level)
+                         << "perclos" << event.metrics.perclos << "yawns" << event.metrics.yawns
+                         << "longest closure" << event.metrics.longestClosureMs << "ms";
+            }
+        }
+
+        const bool pass = monitor.level() == scenario.expected && events == scenario.expectedEvents;
+        failed += pass ? 0 : 1;
+        qDebug() << "Fatigue replay" << scenario.name << ":" << fatigueLevelName(monitor.level())
+                 << "after" << events << "transitions, expected" << fatigueLevelName(scenario.expected)
+                 << "after" << scenario.expectedEvents << (pass ? "- PASS" : "- FAIL");
+    }
+
+    qDebug() << "Fatigue replay:" << (failed == 0 ? "PASS" : "FAIL") << "-" << failed << "of"
+             << scenarios.size() << "scenarios failed";
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,48 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QStringList>
+
+class DetectionEngine;
+struct MotionGateOptions;
+struct TrackerOptions;
+
+// 命令行基准测试：FatigueDetectionSystem --benchmark <图片> [模型路径]
+// 结果通过 qDebug 输出，不启动界面
+class Benchmark
+{
+public:
+    static int run(const QStringList& args);
+
+    // 变化门限回放：FatigueDetectionSystem --gate-replay <视频> [视频...]
+    // 每帧都推理作为基准，分别对比"只有门限"和"门限 + 跟踪器间隔推理"两条路径，
+    // 配置了状态分类器时再加上"门限 + 级联分类"路径，检查是否漏掉闭眼/哈欠片段；
+    // 有漏检时返回非 0。区域推理不在回放范围内
+    static int replayMotionGate(const QStringList& args);
+
+    // 疲劳判定回放：FatigueDetectionSystem --fatigue-replay
+    // 按默认阈值把合成的逐帧检测结果（眨眼、长闭眼、哈欠、恢复、人脸丢失等场景）输入 FatigueMonitor，
+    // 不需要模型和视频，结果确定；最终等级或切换次数与预期不符时返回非 0
+    static int replayFatigue(const QStringList& args);
+
+private:
+    static void benchmarkPreprocess(const QString& imagePath, int iterations);
+    static void benchmarkInference(const QString& imagePath, const QString& modelPath,
+                                   int iterations);
+    static void benchmarkDecode(int iterations);
+    static void benchmarkNms(int iterations);
+    static void benchmarkBatch(const QString& imagePath, const QString& modelPath,
+                               int iterations);
+    // 视频帧在采集、显示缩放和信箱间流转时的 cv::Mat 像素缓冲区分配次数。
+    // 只统计 Mat 缓冲区：信号参数、检测结果 vector、标注等其他堆分配不在统计范围内
+    static void benchmarkMatBuffers(const QString& imagePath, int iterations);
+    // 实时调度下解码慢于源帧率时画面是否仍在推进，停住时返回 false。
+    // 用虚拟时钟驱动调度器，结果与机器负载无关
+    static bool benchmarkPacer(int frames);
+    // 单个片段的回放，返回漏检的片段数，无法打开时返回 -1
+    static int replayClip(DetectionEngine& engine, const QString& clipPath,
+                          const MotionGateOptions& gateOptions,
+                          const TrackerOptions& trackerOptions);
+};
+
+#endif // BENCHMARK_H
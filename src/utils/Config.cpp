@@ -4,6 +4,17 @@
 #include <QFile>
 #include <QDebug>
 
+namespace {
+
+const char* const kThreadRoles[] = {"ui", "capture", "inference", "intra_op", "output", "background"};
+
+std::string threadKey(const std::string& role, const char* field)
+{
+    return "thread_" + role + "_" + field;
+}
+
+} // namespace
+
 Config::Config()
     : m_configFile("config.json")
 {
@@ -13,6 +24,47 @@ Config::Config()
     m_config["confidence_threshold"] = DEFAULT_CONF_THRESHOLD;
     m_config["nms_threshold"] = DEFAULT_NMS_THRESHOLD;
     m_config["save_interval"] = DEFAULT_SAVE_INTERVAL;
+    m_config["engine_pool_size"] = DEFAULT_ENGINE_POOL_SIZE;
+    m_config["intra_op_threads"] = DEFAULT_INTRA_OP_THREADS;
+    m_config["global_thread_pool"] = DEFAULT_GLOBAL_THREAD_POOL;
+    m_config["arena_extend_strategy"] = DEFAULT_ARENA_EXTEND_STRATEGY;
+    m_config["arena_memory_limit_mb"] = DEFAULT_ARENA_MEMORY_LIMIT_MB;
+    m_config["optimized_model_cache"] = DEFAULT_OPTIMIZED_MODEL_CACHE;
+    m_config["capture_queue_policy"] = DEFAULT_CAPTURE_QUEUE_POLICY;
+    m_config["output_queue_policy"] = DEFAULT_OUTPUT_QUEUE_POLICY;
+    m_config["pipeline_queue_capacity"] = DEFAULT_PIPELINE_QUEUE_CAPACITY;
+    m_config["file_pacing_mode"] = DEFAULT_FILE_PACING_MODE;
+    m_config["camera_negotiate_format"] = DEFAULT_CAMERA_NEGOTIATE_FORMAT;
+    m_config["camera_min_fps"] = DEFAULT_CAMERA_MIN_FPS;
+    m_config["motion_gate_enabled"] = DEFAULT_MOTION_GATE_ENABLED;
+    m_config["motion_gate_threshold"] = DEFAULT_MOTION_GATE_THRESHOLD;
+    m_config["motion_gate_refresh_ms"] = DEFAULT_MOTION_GATE_REFRESH_MS;
+    m_config["tracker_detect_interval"] = DEFAULT_TRACKER_DETECT_INTERVAL;
+    m_config["roi_enabled"] = DEFAULT_ROI_ENABLED;
+    m_config["roi_input_size"] = DEFAULT_ROI_INPUT_SIZE;
+    m_config["roi_model_path"] = DEFAULT_ROI_MODEL_PATH;
+    m_config["roi_padding"] = DEFAULT_ROI_PADDING;
+    m_config["roi_reacquire_interval"] = DEFAULT_ROI_REACQUIRE_INTERVAL;
+    m_config["cascade_eye_model_path"] = DEFAULT_CASCADE_EYE_MODEL_PATH;
+    m_config["cascade_mouth_model_path"] = DEFAULT_CASCADE_MOUTH_MODEL_PATH;
+    m_config["cascade_detect_interval"] = DEFAULT_CASCADE_DETECT_INTERVAL;
+    m_config["fatigue_drowsy_perclos"] = DEFAULT_FATIGUE_DROWSY_PERCLOS;
+    m_config["fatigue_critical_perclos"] = DEFAULT_FATIGUE_CRITICAL_PERCLOS;
+    m_config["fatigue_drowsy_yawns"] = DEFAULT_FATIGUE_DROWSY_YAWNS;
+    m_config["fatigue_critical_yawns"] = DEFAULT_FATIGUE_CRITICAL_YAWNS;
+    m_config["fatigue_drowsy_closure_ms"] = DEFAULT_FATIGUE_DROWSY_CLOSURE_MS;
+    m_config["fatigue_critical_closure_ms"] = DEFAULT_FATIGUE_CRITICAL_CLOSURE_MS;
+    m_config["fatigue_recovery_ms"] = DEFAULT_FATIGUE_RECOVERY_MS;
+    m_config["fatigue_perclos_window_ms"] = DEFAULT_FATIGUE_PERCLOS_WINDOW_MS;
+    m_config["fatigue_yawn_window_ms"] = DEFAULT_FATIGUE_YAWN_WINDOW_MS;
+    m_config["fatigue_eyes_closed_class"] = DEFAULT_FATIGUE_EYES_CLOSED_CLASS;
+    m_config["fatigue_yawn_class"] = DEFAULT_FATIGUE_YAWN_CLASS;
+    m_config["show_overlays"] = DEFAULT_SHOW_OVERLAYS;
+    for (const char* role : kThreadRoles) {
+        m_config[QString::fromStdString(threadKey(role, "cpus"))] = DEFAULT_THREAD_CPUS;
+        m_config[QString::fromStdString(threadKey(role, "scheduler"))] = DEFAULT_THREAD_SCHEDULER;
+        m_config[QString::fromStdString(threadKey(role, "priority"))] = DEFAULT_THREAD_PRIORITY;
+    }
 }
 
 Config::~Config() = default;
@@ -123,6 +175,396 @@ void Config::setSaveInterval(int interval)
     setInt("save_interval", interval);
 }
 
+int Config::getEnginePoolSize() const
+{
+    return getInt("engine_pool_size", DEFAULT_ENGINE_POOL_SIZE);
+}
+
+void Config::setEnginePoolSize(int size)
+{
+    setInt("engine_pool_size", size);
+}
+
+int Config::getIntraOpThreads() const
+{
+    return getInt("intra_op_threads", DEFAULT_INTRA_OP_THREADS);
+}
+
+void Config::setIntraOpThreads(int threads)
+{
+    setInt("intra_op_threads", threads);
+}
+
+bool Config::getGlobalThreadPool() const
+{
+    return getBool("global_thread_pool", DEFAULT_GLOBAL_THREAD_POOL);
+}
+
+void Config::setGlobalThreadPool(bool enable)
+{
+    setBool("global_thread_pool", enable);
+}
+
+std::string Config::getArenaExtendStrategy() const
+{
+    return getString("arena_extend_strategy", DEFAULT_ARENA_EXTEND_STRATEGY);
+}
+
+void Config::setArenaExtendStrategy(const std::string& strategy)
+{
+    setString("arena_extend_strategy", strategy);
+}
+
+int Config::getArenaMemoryLimitMB() const
+{
+    return getInt("arena_memory_limit_mb", DEFAULT_ARENA_MEMORY_LIMIT_MB);
+}
+
+void Config::setArenaMemoryLimitMB(int limit)
+{
+    setInt("arena_memory_limit_mb", limit);
+}
+
+bool Config::getOptimizedModelCache() const
+{
+    return getBool("optimized_model_cache", DEFAULT_OPTIMIZED_MODEL_CACHE);
+}
+
+void Config::setOptimizedModelCache(bool enable)
+{
+    setBool("optimized_model_cache", enable);
+}
+
+std::string Config::getCaptureQueuePolicy() const
+{
+    return getString("capture_queue_policy", DEFAULT_CAPTURE_QUEUE_POLICY);
+}
+
+void Config::setCaptureQueuePolicy(const std::string& policy)
+{
+    setString("capture_queue_policy", policy);
+}
+
+std::string Config::getOutputQueuePolicy() const
+{
+    return getString("output_queue_policy", DEFAULT_OUTPUT_QUEUE_POLICY);
+}
+
+void Config::setOutputQueuePolicy(const std::string& policy)
+{
+    setString("output_queue_policy", policy);
+}
+
+int Config::getPipelineQueueCapacity() const
+{
+    return getInt("pipeline_queue_capacity", DEFAULT_PIPELINE_QUEUE_CAPACITY);
+}
+
+void Config::setPipelineQueueCapacity(int capacity)
+{
+    setInt("pipeline_queue_capacity", capacity);
+}
+
+std::string Config::getFilePacingMode() const
+{
+    return getString("file_pacing_mode", DEFAULT_FILE_PACING_MODE);
+}
+
+void Config::setFilePacingMode(const std::string& mode)
+{
+    setString("file_pacing_mode", mode);
+}
+
+bool Config::getCameraNegotiateFormat() const
+{
+    return getBool("camera_negotiate_format", DEFAULT_CAMERA_NEGOTIATE_FORMAT);
+}
+
+void Config::setCameraNegotiateFormat(bool enable)
+{
+    setBool("camera_negotiate_format", enable);
+}
+
+int Config::getCameraMinFps() const
+{
+    return getInt("camera_min_fps", DEFAULT_CAMERA_MIN_FPS);
+}
+
+void Config::setCameraMinFps(int fps)
+{
+    setInt("camera_min_fps", fps);
+}
+
+bool Config::getMotionGateEnabled() const
+{
+    return getBool("motion_gate_enabled", DEFAULT_MOTION_GATE_ENABLED);
+}
+
+void Config::setMotionGateEnabled(bool enable)
+{
+    setBool("motion_gate_enabled", enable);
+}
+
+double Config::getMotionGateThreshold() const
+{
+    return getDouble("motion_gate_threshold", DEFAULT_MOTION_GATE_THRESHOLD);
+}
+
+void Config::setMotionGateThreshold(double threshold)
+{
+    setDouble("motion_gate_threshold", threshold);
+}
+
+int Config::getMotionGateRefreshMs() const
+{
+    return getInt("motion_gate_refresh_ms", DEFAULT_MOTION_GATE_REFRESH_MS);
+}
+
+void Config::setMotionGateRefreshMs(int intervalMs)
+{
+    setInt("motion_gate_refresh_ms", intervalMs);
+}
+
+int Config::getTrackerDetectInterval() const
+{
+    return getInt("tracker_detect_interval", DEFAULT_TRACKER_DETECT_INTERVAL);
+}
+
+void Config::setTrackerDetectInterval(int interval)
+{
+    setInt("tracker_detect_interval", interval);
+}
+
+bool Config::getRoiEnabled() const
+{
+    return getBool("roi_enabled", DEFAULT_ROI_ENABLED);
+}
+
+void Config::setRoiEnabled(bool enable)
+{
+    setBool("roi_enabled", enable);
+}
+
+int Config::getRoiInputSize() const
+{
+    return getInt("roi_input_size", DEFAULT_ROI_INPUT_SIZE);
+}
+
+void Config::setRoiInputSize(int size)
+{
+    setInt("roi_input_size", size);
+}
+
+std::string Config::getRoiModelPath() const
+{
+    return getString("roi_model_path", DEFAULT_ROI_MODEL_PATH);
+}
+
+void Config::setRoiModelPath(const std::string& path)
+{
+    setString("roi_model_path", path);
+}
+
+double Config::getRoiPadding() const
+{
+    return getDouble("roi_padding", DEFAULT_ROI_PADDING);
+}
+
+void Config::setRoiPadding(double padding)
+{
+    setDouble("roi_padding", padding);
+}
+
+int Config::getRoiReacquireInterval() const
+{
+    return getInt("roi_reacquire_interval", DEFAULT_ROI_REACQUIRE_INTERVAL);
+}
+
+void Config::setRoiReacquireInterval(int interval)
+{
+    setInt("roi_reacquire_interval", interval);
+}
+
+std::string Config::getCascadeEyeModelPath() const
+{
+    return getString("cascade_eye_model_path", DEFAULT_CASCADE_EYE_MODEL_PATH);
+}
+
+void Config::setCascadeEyeModelPath(const std::string& path)
+{
+    setString("cascade_eye_model_path", path);
+}
+
+std::string Config::getCascadeMouthModelPath() const
+{
+    return getString("cascade_mouth_model_path", DEFAULT_CASCADE_MOUTH_MODEL_PATH);
+}
+
+void Config::setCascadeMouthModelPath(const std::string& path)
+{
+    setString("cascade_mouth_model_path", path);
+}
+
+int Config::getCascadeDetectInterval() const
+{
+    return getInt("cascade_detect_interval", DEFAULT_CASCADE_DETECT_INTERVAL);
+}
+
+void Config::setCascadeDetectInterval(int interval)
+{
+    setInt("cascade_detect_interval", interval);
+}
+
+double Config::getFatigueDrowsyPerclos() const
+{
+    return getDouble("fatigue_drowsy_perclos", DEFAULT_FATIGUE_DROWSY_PERCLOS);
+}
+
+void Config::setFatigueDrowsyPerclos(double ratio)
+{
+    setDouble("fatigue_drowsy_perclos", ratio);
+}
+
+double Config::getFatigueCriticalPerclos() const
+{
+    return getDouble("fatigue_critical_perclos", DEFAULT_FATIGUE_CRITICAL_PERCLOS);
+}
+
+void Config::setFatigueCriticalPerclos(double ratio)
+{
+    setDouble("fatigue_critical_perclos", ratio);
+}
+
+int Config::getFatigueDrowsyYawns() const
+{
+    return getInt("fatigue_drowsy_yawns", DEFAULT_FATIGUE_DROWSY_YAWNS);
+}
+
+void Config::setFatigueDrowsyYawns(int yawns)
+{
+    setInt("fatigue_drowsy_yawns", yawns);
+}
+
+int Config::getFatigueCriticalYawns() const
+{
+    return getInt("fatigue_critical_yawns", DEFAULT_FATIGUE_CRITICAL_YAWNS);
+}
+
+void Config::setFatigueCriticalYawns(int yawns)
+{
+    setInt("fatigue_critical_yawns", yawns);
+}
+
+int Config::getFatigueDrowsyClosureMs() const
+{
+    return getInt("fatigue_drowsy_closure_ms", DEFAULT_FATIGUE_DROWSY_CLOSURE_MS);
+}
+
+void Config::setFatigueDrowsyClosureMs(int durationMs)
+{
+    setInt("fatigue_drowsy_closure_ms", durationMs);
+}
+
+int Config::getFatigueCriticalClosureMs() const
+{
+    return getInt("fatigue_critical_closure_ms", DEFAULT_FATIGUE_CRITICAL_CLOSURE_MS);
+}
+
+void Config::setFatigueCriticalClosureMs(int durationMs)
+{
+    setInt("fatigue_critical_closure_ms", durationMs);
+}
+
+int Config::getFatigueRecoveryMs() const
+{
+    return getInt("fatigue_recovery_ms", DEFAULT_FATIGUE_RECOVERY_MS);
+}
+
+void Config::setFatigueRecoveryMs(int durationMs)
+{
+    setInt("fatigue_recovery_ms", durationMs);
+}
+
+int Config::getFatiguePerclosWindowMs() const
+{
+    return getInt("fatigue_perclos_window_ms", DEFAULT_FATIGUE_PERCLOS_WINDOW_MS);
+}
+
+void Config::setFatiguePerclosWindowMs(int windowMs)
+{
+    setInt("fatigue_perclos_window_ms", windowMs);
+}
+
+int Config::getFatigueYawnWindowMs() const
+{
+    return getInt("fatigue_yawn_window_ms", DEFAULT_FATIGUE_YAWN_WINDOW_MS);
+}
+
+void Config::setFatigueYawnWindowMs(int windowMs)
+{
+    setInt("fatigue_yawn_window_ms", windowMs);
+}
+
+int Config::getFatigueEyesClosedClass() const
+{
+    return getInt("fatigue_eyes_closed_class", DEFAULT_FATIGUE_EYES_CLOSED_CLASS);
+}
+
+void Config::setFatigueEyesClosedClass(int classId)
+{
+    setInt("fatigue_eyes_closed_class", classId);
+}
+
+int Config::getFatigueYawnClass() const
+{
+    return getInt("fatigue_yawn_class", DEFAULT_FATIGUE_YAWN_CLASS);
+}
+
+void Config::setFatigueYawnClass(int classId)
+{
+    setInt("fatigue_yawn_class", classId);
+}
+
+bool Config::getShowOverlays() const
+{
+    return getBool("show_overlays", DEFAULT_SHOW_OVERLAYS);
+}
+
+void Config::setShowOverlays(bool show)
+{
+    setBool("show_overlays", show);
+}
+
+std::string Config::getThreadCpus(const std::string& role) const
+{
+    return getString(threadKey(role, "cpus"), DEFAULT_THREAD_CPUS);
+}
+
+void Config::setThreadCpus(const std::string& role, const std::string& cpus)
+{
+    setString(threadKey(role, "cpus"), cpus);
+}
+
+std::string Config::getThreadScheduler(const std::string& role) const
+{
+    return getString(threadKey(role, "scheduler"), DEFAULT_THREAD_SCHEDULER);
+}
+
+void Config::setThreadScheduler(const std::string& role, const std::string& scheduler)
+{
+    setString(threadKey(role, "scheduler"), scheduler);
+}
+
+int Config::getThreadPriority(const std::string& role) const
+{
+    return getInt(threadKey(role, "priority"), DEFAULT_THREAD_PRIORITY);
+}
+
+void Config::setThreadPriority(const std::string& role, int priority)
+{
+    setInt(threadKey(role, "priority"), priority);
+}
+
 std::string Config::getString(const std::string& key, const std::string& defaultValue) const
 {
     QString qKey = QString::fromStdString(key);
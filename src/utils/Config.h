@@ -33,6 +33,120 @@ public:
     int getSaveInterval() const;
     void setSaveInterval(int interval);
 
+    // 推理线程划分：引擎池会话数 × 每会话 intra-op 线程数（0 表示按核数自动分配）
+    int getEnginePoolSize() const;
+    void setEnginePoolSize(int size);
+    int getIntraOpThreads() const;
+    void setIntraOpThreads(int threads);
+
+    // ONNX Runtime 内存：全局线程池、共享 arena 扩展策略与上限
+    bool getGlobalThreadPool() const;
+    void setGlobalThreadPool(bool enable);
+    std::string getArenaExtendStrategy() const;
+    void setArenaExtendStrategy(const std::string& strategy);
+    int getArenaMemoryLimitMB() const;
+    void setArenaMemoryLimitMB(int limit);
+
+    // 优化后模型缓存
+    bool getOptimizedModelCache() const;
+    void setOptimizedModelCache(bool enable);
+
+    // 视频流水线：队列满时的策略（"drop_oldest" 或 "block"）与队列容量
+    std::string getCaptureQueuePolicy() const;
+    void setCaptureQueuePolicy(const std::string& policy);
+    std::string getOutputQueuePolicy() const;
+    void setOutputQueuePolicy(const std::string& policy);
+    int getPipelineQueueCapacity() const;
+    void setPipelineQueueCapacity(int capacity);
+
+    // 视频文件帧调度："every_frame" 逐帧处理，"realtime" 落后时跳帧
+    std::string getFilePacingMode() const;
+    void setFilePacingMode(const std::string& mode);
+
+    // 本地摄像头采集格式协商：按模型输入尺寸选最省的格式和分辨率，帧率不低于最低值
+    bool getCameraNegotiateFormat() const;
+    void setCameraNegotiateFormat(bool enable);
+    int getCameraMinFps() const;
+    void setCameraMinFps(int fps);
+
+    // 推理前的变化门限：画面变化（最大块平均绝对差）低于阈值时沿用上次结果，
+    // 静止时至少每 refresh_ms 毫秒推理一次
+    bool getMotionGateEnabled() const;
+    void setMotionGateEnabled(bool enable);
+    double getMotionGateThreshold() const;
+    void setMotionGateThreshold(double threshold);
+    int getMotionGateRefreshMs() const;
+    void setMotionGateRefreshMs(int intervalMs);
+
+    // 检测跟踪：每隔多少帧推理一次（轨迹丢失时立即推理），1 表示每帧推理
+    int getTrackerDetectInterval() const;
+    void setTrackerDetectInterval(int interval);
+
+    // 区域推理：轨迹稳定时只在外扩 roi_padding 的人脸区域内按 roi_input_size 推理，
+    // 每 roi_reacquire_interval 次整帧推理一次。主模型宽高为动态维度或配置了 roi_model_path
+    // 时才生效，roi_model_path 为同类别、较小固定输入的模型
+    bool getRoiEnabled() const;
+    void setRoiEnabled(bool enable);
+    int getRoiInputSize() const;
+    void setRoiInputSize(int size);
+    std::string getRoiModelPath() const;
+    void setRoiModelPath(const std::string& path);
+    double getRoiPadding() const;
+    void setRoiPadding(double padding);
+    int getRoiReacquireInterval() const;
+    void setRoiReacquireInterval(int interval);
+
+    // 级联：眼部/嘴部状态分类器（与检测模型相同的预处理，输出闭眼/张嘴的 logit），
+    // 任一路径非空即启用；启用后检测每 cascade_detect_interval 帧运行一次，
+    // 其余有变化的帧由分类器在上次检测的人脸框内判断状态
+    std::string getCascadeEyeModelPath() const;
+    void setCascadeEyeModelPath(const std::string& path);
+    std::string getCascadeMouthModelPath() const;
+    void setCascadeMouthModelPath(const std::string& path);
+    int getCascadeDetectInterval() const;
+    void setCascadeDetectInterval(int interval);
+
+    // 疲劳判定：PERCLOS 窗口内闭眼时间占比和最长一次闭眼、哈欠窗口内哈欠次数，
+    // 任一达到阈值即升级，指标持续 recovery_ms 低于阈值才降级，只有等级切换写入数据库。
+    // 疲劳阈值高于严重疲劳阈值等不合理的组合由 FatigueMonitor::validated() 修正
+    double getFatigueDrowsyPerclos() const;
+    void setFatigueDrowsyPerclos(double ratio);
+    double getFatigueCriticalPerclos() const;
+    void setFatigueCriticalPerclos(double ratio);
+    int getFatigueDrowsyYawns() const;
+    void setFatigueDrowsyYawns(int yawns);
+    int getFatigueCriticalYawns() const;
+    void setFatigueCriticalYawns(int yawns);
+    int getFatigueDrowsyClosureMs() const;
+    void setFatigueDrowsyClosureMs(int durationMs);
+    int getFatigueCriticalClosureMs() const;
+    void setFatigueCriticalClosureMs(int durationMs);
+    int getFatigueRecoveryMs() const;
+    void setFatigueRecoveryMs(int durationMs);
+    int getFatiguePerclosWindowMs() const;
+    void setFatiguePerclosWindowMs(int windowMs);
+    int getFatigueYawnWindowMs() const;
+    void setFatigueYawnWindowMs(int windowMs);
+    // 检测模型中闭眼、哈欠对应的类别 ID（"normal" 固定为 2），模型类别顺序与默认不同时在此改正
+    int getFatigueEyesClosedClass() const;
+    void setFatigueEyesClosedClass(int classId);
+    int getFatigueYawnClass() const;
+    void setFatigueYawnClass(int classId);
+
+    // 显示时在画面上绘制检测框和标签
+    bool getShowOverlays() const;
+    void setShowOverlays(bool show);
+
+    // 线程放置，role 为 ui / capture / inference / intra_op / output / background
+    // CPU 列表如 "2-3,6"，空表示不限制；调度策略 other / batch / idle / fifo / rr；
+    // 优先级对 other/batch 为 nice 值，对 fifo/rr 为实时优先级
+    std::string getThreadCpus(const std::string& role) const;
+    void setThreadCpus(const std::string& role, const std::string& cpus);
+    std::string getThreadScheduler(const std::string& role) const;
+    void setThreadScheduler(const std::string& role, const std::string& scheduler);
+    int getThreadPriority(const std::string& role) const;
+    void setThreadPriority(const std::string& role, int priority);
+
     // 通用配置项
     std::string getString(const std::string& key, const std::string& defaultValue = "") const;
     void setString(const std::string& key, const std::string& value);
@@ -56,6 +170,45 @@ private:
     static constexpr float DEFAULT_CONF_THRESHOLD = 0.6f;
     static constexpr float DEFAULT_NMS_THRESHOLD = 0.45f;
     static constexpr int DEFAULT_SAVE_INTERVAL = 1000;
+    static constexpr int DEFAULT_ENGINE_POOL_SIZE = 2;
+    static constexpr int DEFAULT_INTRA_OP_THREADS = 0;
+    static constexpr bool DEFAULT_GLOBAL_THREAD_POOL = true;
+    static constexpr const char* DEFAULT_ARENA_EXTEND_STRATEGY = "same_as_requested";
+    static constexpr int DEFAULT_ARENA_MEMORY_LIMIT_MB = 0;
+    static constexpr bool DEFAULT_OPTIMIZED_MODEL_CACHE = true;
+    static constexpr const char* DEFAULT_CAPTURE_QUEUE_POLICY = "drop_oldest";
+    static constexpr const char* DEFAULT_OUTPUT_QUEUE_POLICY = "block";
+    static constexpr int DEFAULT_PIPELINE_QUEUE_CAPACITY = 2;
+    static constexpr const char* DEFAULT_FILE_PACING_MODE = "every_frame";
+    static constexpr bool DEFAULT_CAMERA_NEGOTIATE_FORMAT = true;
+    static constexpr int DEFAULT_CAMERA_MIN_FPS = 15;
+    static constexpr bool DEFAULT_MOTION_GATE_ENABLED = true;
+    static constexpr double DEFAULT_MOTION_GATE_THRESHOLD = 3.0;
+    static constexpr int DEFAULT_MOTION_GATE_REFRESH_MS = 200;
+    static constexpr int DEFAULT_TRACKER_DETECT_INTERVAL = 2;
+    static constexpr bool DEFAULT_ROI_ENABLED = true;
+    static constexpr int DEFAULT_ROI_INPUT_SIZE = 320;
+    static constexpr const char* DEFAULT_ROI_MODEL_PATH = "";
+    static constexpr double DEFAULT_ROI_PADDING = 0.5;
+    static constexpr int DEFAULT_ROI_REACQUIRE_INTERVAL = 10;
+    static constexpr const char* DEFAULT_CASCADE_EYE_MODEL_PATH = "";
+    static constexpr const char* DEFAULT_CASCADE_MOUTH_MODEL_PATH = "";
+    static constexpr int DEFAULT_CASCADE_DETECT_INTERVAL = 10;
+    static constexpr double DEFAULT_FATIGUE_DROWSY_PERCLOS = 0.15;
+    static constexpr double DEFAULT_FATIGUE_CRITICAL_PERCLOS = 0.30;
+    static constexpr int DEFAULT_FATIGUE_DROWSY_YAWNS = 3;
+    static constexpr int DEFAULT_FATIGUE_CRITICAL_YAWNS = 5;
+    static constexpr int DEFAULT_FATIGUE_DROWSY_CLOSURE_MS = 1000;
+    static constexpr int DEFAULT_FATIGUE_CRITICAL_CLOSURE_MS = 2000;
+    static constexpr int DEFAULT_FATIGUE_RECOVERY_MS = 5000;
+    static constexpr int DEFAULT_FATIGUE_PERCLOS_WINDOW_MS = 60000;
+    static constexpr int DEFAULT_FATIGUE_YAWN_WINDOW_MS = 300000;
+    static constexpr int DEFAULT_FATIGUE_EYES_CLOSED_CLASS = 0;
+    static constexpr int DEFAULT_FATIGUE_YAWN_CLASS = 1;
+    static constexpr bool DEFAULT_SHOW_OVERLAYS = true;
+    static constexpr const char* DEFAULT_THREAD_CPUS = "";
+    static constexpr const char* DEFAULT_THREAD_SCHEDULER = "other";
+    static constexpr int DEFAULT_THREAD_PRIORITY = 0;
 };
 
 #endif // CONFIG_H